@@ -0,0 +1,71 @@
+#include <getopt.h>
+
+#include <fstream>
+#include <iostream>
+#include <result_log.hpp>
+
+void printHelp();
+
+int main(int argc, char* argv[])
+{
+  std::string input_file = "";
+  std::string output_file = "";
+
+  struct option longopts[] = {
+      {"input", required_argument, 0, 'i'},
+      {"output", required_argument, 0, 'o'},
+      {"help", no_argument, 0, 'h'},
+      {0, 0, 0, 0},
+  };
+
+  // command line args
+  int opt, longindex;
+  opterr = 0;  // ignore getopt error
+  while ((opt = getopt_long(argc, argv, "i:o:h", longopts, &longindex)) !=
+         -1) {
+    switch (opt) {
+      case 'i':
+        input_file = std::string(optarg);
+        break;
+      case 'o':
+        output_file = std::string(optarg);
+        break;
+      case 'h':
+        printHelp();
+        return 0;
+      default:
+        break;
+    }
+  }
+
+  if (input_file.length() == 0) {
+    std::cout << "specify binary result using -i [RESULT-FILE], e.g.,"
+              << std::endl;
+    std::cout << "> ./convert_log -i result.bin -o result.txt" << std::endl;
+    return 0;
+  }
+  if (!ResultLogReader::isBinary(input_file)) {
+    std::cout << "error@convert_log: not a binary result, " << input_file
+              << std::endl;
+    return 1;
+  }
+
+  ResultLogReader reader(input_file);
+  if (output_file.length() == 0) {
+    reader.toText(std::cout);
+  } else {
+    std::ofstream log(output_file, std::ios::out);
+    reader.toText(log);
+  }
+  return 0;
+}
+
+void printHelp()
+{
+  std::cout << "\nUsage: ./convert_log [OPTIONS]\n"
+            << "\nconvert a result of --log-format=binary to the text\n\n"
+            << "  -i --input [FILE_PATH]        binary result file path\n"
+            << "  -o --output [FILE_PATH]       text result file path, "
+               "default: stdout\n"
+            << "  -h --help                     help" << std::endl;
+}
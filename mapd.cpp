@@ -30,17 +30,23 @@ int main(int argc, char* argv[])
       {"help", no_argument, 0, 'h'},
       {"time-limit", required_argument, 0, 'T'},
       {"log-short", no_argument, 0, 'L'},
+      {"log-format", required_argument, 0, 'F'},
       {"use-distance-table", no_argument, 0, 'd'},
+      {"distance-cache", no_argument, 0, 'C'},
+      {"threads", required_argument, 0, 't'},
       {0, 0, 0, 0},
   };
   bool log_short = false;
+  LogFormat log_format = LogFormat::TEXT;
   int max_comp_time = -1;
   bool use_distance_table = false;
+  bool use_distance_cache = false;
+  int num_threads = DEFAULT_NUM_THREADS;
 
   // command line args
   int opt, longindex;
   opterr = 0;  // ignore getopt error
-  while ((opt = getopt_long(argc, argv, "i:o:s:vhT:Ld", longopts,
+  while ((opt = getopt_long(argc, argv, "i:o:s:vhT:LdCt:F:", longopts,
                             &longindex)) != -1) {
     switch (opt) {
       case 'i':
@@ -61,12 +67,27 @@ int main(int argc, char* argv[])
       case 'L':
         log_short = true;
         break;
+      case 'F':
+        if (std::string(optarg) == "binary") {
+          log_format = LogFormat::BINARY;
+        } else if (std::string(optarg) != "text") {
+          std::cout << "error@mapd: unknown log format, " << optarg
+                    << std::endl;
+          return 1;
+        }
+        break;
       case 'T':
         max_comp_time = std::atoi(optarg);
         break;
       case 'd':
         use_distance_table = true;
         break;
+      case 'C':
+        use_distance_cache = true;
+        break;
+      case 't':
+        num_threads = std::atoi(optarg);
+        break;
       default:
         break;
     }
@@ -89,8 +110,12 @@ int main(int argc, char* argv[])
   auto solver =
       getSolver(solver_name, &P, verbose, argc, argv_copy, use_distance_table);
   solver->setLogShort(log_short);
+  solver->setLogFormat(log_format);
+  solver->setLogFile(output_file);
+  solver->setUseDistanceCache(use_distance_cache);
+  solver->setNumThreads(num_threads);
   solver->solve();
-  if (solver->succeed() && !solver->getSolution().validate(&P)) {
+  if (solver->succeed() && !solver->getSolution().validate(&P, num_threads)) {
     std::cout << "error@mapd: invalid results" << std::endl;
     return 0;
   }
@@ -135,9 +160,15 @@ void printHelp()
       << "  -v --verbose                  print additional info\n"
       << "  -h --help                     help\n"
       << "  -d --use-distance-table       use pre-computed distance table\n"
+      << "  -C --distance-cache           reuse distance table cached next "
+         "to the map file\n"
+      << "  -t --threads [INT]            number of threads used in "
+         "pre-processing\n"
       << "  -s --solver [SOLVER_NAME]     solver, choose from the below\n"
       << "  -T --time-limit [INT]         max computation time (ms)\n"
       << "  -L --log-short                use short log\n"
+      << "  -F --log-format [text|binary] format of the result, binary is "
+         "converted by convert_log\n"
       << "\nSolver Options:" << std::endl;
   // each solver
   PIBT_MAPD::printHelp();
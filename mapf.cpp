@@ -32,17 +32,27 @@ int main(int argc, char* argv[])
       {"help", no_argument, 0, 'h'},
       {"time-limit", required_argument, 0, 'T'},
       {"log-short", no_argument, 0, 'L'},
+      {"log-format", required_argument, 0, 'F'},
       {"make-scen", no_argument, 0, 'P'},
+      {"threads", required_argument, 0, 't'},
+      {"lazy-distance", required_argument, 0, 'l'},
+      {"distance-cache", no_argument, 0, 'C'},
+      {"keyframe-interval", required_argument, 0, 'K'},
       {0, 0, 0, 0},
   };
   bool make_scen = false;
   bool log_short = false;
+  LogFormat log_format = LogFormat::TEXT;
   int max_comp_time = -1;
+  int num_threads = DEFAULT_NUM_THREADS;
+  int lazy_distance_budget = -1;
+  bool use_distance_cache = false;
+  int keyframe_interval = 0;
 
   // command line args
   int opt, longindex;
   opterr = 0;  // ignore getopt error
-  while ((opt = getopt_long(argc, argv, "i:o:s:vhPT:L", longopts,
+  while ((opt = getopt_long(argc, argv, "i:o:s:vhPT:Lt:l:CF:K:", longopts,
                             &longindex)) != -1) {
     switch (opt) {
       case 'i':
@@ -66,9 +76,30 @@ int main(int argc, char* argv[])
       case 'L':
         log_short = true;
         break;
+      case 'F':
+        if (std::string(optarg) == "binary") {
+          log_format = LogFormat::BINARY;
+        } else if (std::string(optarg) != "text") {
+          std::cout << "error@mapf: unknown log format, " << optarg
+                    << std::endl;
+          return 1;
+        }
+        break;
       case 'T':
         max_comp_time = std::atoi(optarg);
         break;
+      case 't':
+        num_threads = std::atoi(optarg);
+        break;
+      case 'l':
+        lazy_distance_budget = std::atoi(optarg);
+        break;
+      case 'C':
+        use_distance_cache = true;
+        break;
+      case 'K':
+        keyframe_interval = std::atoi(optarg);
+        break;
       default:
         break;
     }
@@ -96,8 +127,16 @@ int main(int argc, char* argv[])
   // solve
   auto solver = getSolver(solver_name, &P, verbose, argc, argv_copy);
   solver->setLogShort(log_short);
+  solver->setLogFormat(log_format);
+  solver->setLogFile(output_file);
+  solver->setNumThreads(num_threads);
+  if (lazy_distance_budget >= 0) {
+    solver->setLazyDistanceTable(lazy_distance_budget);
+  }
+  solver->setUseDistanceCache(use_distance_cache);
+  solver->setKeyframeInterval(keyframe_interval);
   solver->solve();
-  if (solver->succeed() && !solver->getSolution().validate(&P)) {
+  if (solver->succeed() && !solver->getSolution().validate(&P, num_threads)) {
     std::cout << "error@mapf: invalid results" << std::endl;
     return 0;
   }
@@ -146,7 +185,17 @@ void printHelp()
             << "  -h --help                     help\n"
             << "  -s --solver [SOLVER_NAME]     solver, choose from the below\n"
             << "  -T --time-limit [INT]         max computation time (ms)\n"
-            << "  -L --log-short                use short log"
+            << "  -L --log-short                use short log\n"
+            << "  -F --log-format [text|binary] format of the result, "
+               "binary is converted by convert_log\n"
+            << "  -t --threads [INT]            number of threads used in "
+               "pre-processing\n"
+            << "  -l --lazy-distance [INT]      compute distances on demand "
+               "within memory budget (MB), 0: unlimited\n"
+            << "  -C --distance-cache           reuse distance table "
+               "cached next to the map file\n"
+            << "  -K --keyframe-interval [INT]  keep full timesteps of the "
+               "solution every INT steps, others as changes, 0: all\n"
             << "  -P --make-scen                make scenario file using "
                "random starts/goals"
             << "\n\nSolver Options:" << std::endl;
@@ -0,0 +1,70 @@
+/*
+ * Persistent cache of distance rows, stored next to the map file
+ * or in a given directory
+ *
+ * - the file is keyed by a content hash of the graph,
+ *   a stale file (e.g., the map was edited) is ignored and overwritten
+ * - rows are keyed by goal, entries are [cell][state] where cells are
+ *   free nodes in ascending order of id
+ * - distances are stored without the cap of max_timestep
+ * - the file is mapped read-only, new rows are added by rewriting the file
+ *   and replacing it atomically
+ *
+ * format: Header, goal ids (int32 x rows), rows (uint16 x rows x cells x stride)
+ */
+
+#pragma once
+#include <graph.hpp>
+#include <cstdint>
+#include <unordered_map>
+
+class DistanceCache
+{
+public:
+  using Dist = std::uint16_t;
+  static constexpr Dist UNREACHABLE = UINT16_MAX;
+
+private:
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t stride;
+    std::uint64_t hash;
+    std::uint32_t cells_size;
+    std::uint32_t rows_size;
+  };
+  static constexpr char MAGIC[8] = "PIBTDST";
+  static constexpr std::uint32_t VERSION = 1;
+
+  const std::string file;
+  const int stride;  // states per cell, e.g., 4 with orientation
+  int cells_size;
+  std::uint64_t hash;
+
+  // mapped file
+  void* data;
+  std::size_t data_size;
+  std::unordered_map<int, const Dist*> rows;  // goal id -> row
+
+  void open();
+  void close();
+  void warn(const std::string& msg) const;
+
+public:
+  // dir: directory of the file, empty for next to the map file
+  DistanceCache(Graph* G, const int _stride, const std::string& dir = "");
+  ~DistanceCache();
+
+  // cached row of the goal, nullptr if not found
+  const Dist* find(Node* const g) const;
+  int getRowsSize() const { return rows.size(); }
+  int getCellsSize() const { return cells_size; }
+  std::size_t getRowSize() const { return (std::size_t)cells_size * stride; }
+
+  // write cached rows together with new ones, {goal id, row}
+  void store(const std::vector<std::pair<int, const Dist*>>& new_rows);
+
+  static std::uint64_t getHash(Graph* G);
+  static std::string getFileName(Graph* G, const int stride,
+                                 const std::string& dir = "");
+};
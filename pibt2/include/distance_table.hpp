@@ -0,0 +1,123 @@
+/*
+ * Distance table towards goals, considering orientation or not
+ *
+ * - rows are keyed by goal, agents with the same goal share one row
+ * - cells are indexed densely, obstacles take no space
+ * - all rows are stored in one contiguous uint16 array,
+ *   [row][cell][orientation], orientation is omitted without orientation
+ * - distances are saturated at max_dist (usually max_timestep)
+ * - with orientation, the minimum over orientations is kept per cell as well,
+ *   [row][cell], so that orientation-free queries are one lookup
+ * - rows can be loaded from and saved to DistanceCache
+ *
+ * In lazy mode, a row is a resumable BFS that is expanded only until the
+ * queried state is reached. Rows are kept in a bounded number of slots and
+ * the least recently used row is evicted when the slots are exhausted.
+ */
+
+#pragma once
+#include <graph.hpp>
+#include <cstdint>
+
+#include "distance_cache.hpp"
+#include "orientation.hpp"
+
+class DistanceTable
+{
+public:
+  using Dist = std::uint16_t;
+  static constexpr int NIL = -1;
+  static constexpr int ORIENTATIONS = 4;
+
+private:
+  Graph* const G;
+  const Dist max_dist;  // distance for unreachable states
+  const int stride;     // states per cell, ORIENTATIONS or 1
+
+  std::vector<int> cell_index;   // node id -> cell index, NIL for obstacles
+  Nodes cells;                   // cell index -> node
+  Nodes goals;                   // row -> goal
+  std::vector<int> row_of_goal;  // cell index -> row, NIL if not registered
+  mutable std::vector<Dist> table;  // [row or slot][cell][orientation]
+  std::vector<Dist> collapsed;      // [row][cell], built only without lazy
+
+  // lazy mode
+  struct Slot {
+    int row;                 // row held by this slot
+    std::uint64_t last_used; // for LRU eviction
+    std::vector<int> OPEN;   // BFS queue, each state enqueued at most once
+    int head;                // next state to expand
+    int tail;                // end of queue
+  };
+  bool lazy;
+  int max_slots;
+  mutable std::vector<Slot> slots;
+  mutable std::vector<int> slot_of_row;  // row -> slot, NIL if not resident
+  mutable std::uint64_t clock;
+  mutable int evicted_cnt;
+
+  // state = cell * ORIENTATIONS + orientation, or cell without orientation
+  int getStateIndex(const int cell, const Orientation dir) const
+  {
+    return (stride == 1) ? cell : cell * ORIENTATIONS + static_cast<int>(dir);
+  }
+  std::size_t getRowOffset(const int row) const
+  {
+    return (std::size_t)row * cells.size() * stride;
+  }
+
+  // (multi-source) BFS from (all orientations at) the goal,
+  // states at distance limit or more are not expanded
+  void createRow(const int row, const Dist limit);
+  void initRow(Node* const g, Dist* dist, int* OPEN, int& tail,
+               const Dist limit) const;
+  void expand(Dist* dist, int* OPEN, int& head, int& tail,
+              const Dist limit) const;
+  // minimum over orientations of a built row
+  void collapseRow(const int row);
+
+  // lazy mode
+  int getLazy(const int row, const int state) const;
+  int getLazyAnyDir(const int row, const int cell) const;
+  int assignSlot(const int row) const;
+
+public:
+  DistanceTable(Graph* _G, const int _max_dist,
+                const bool with_orientation = true);
+  ~DistanceTable() {}
+
+  // register a goal and return its row
+  int addGoal(Node* const g);
+  // row of a registered goal, NIL if not registered
+  int getRow(Node* const g) const;
+  int getRowsSize() const { return goals.size(); }
+
+  // compute all registered rows,
+  // with cache, reuse cached rows and add the computed ones to cache
+  void build(const int num_threads = 1, DistanceCache* cache = nullptr);
+  // compute rows on demand instead of build,
+  // memory_budget in bytes limits resident rows, zero for unlimited
+  void setLazy(const std::size_t memory_budget);
+
+  // distance from (v, dir) to the goal of the row, with orientation
+  int get(const int row, Node* const v, const Orientation dir) const
+  {
+    const int s = getStateIndex(cell_index[v->id], dir);
+    if (lazy) return getLazy(row, s);
+    return table[getRowOffset(row) + s];
+  }
+  // minimum distance over orientations at v
+  int get(const int row, Node* const v) const
+  {
+    const int c = cell_index[v->id];
+    if (lazy) return getLazyAnyDir(row, c);
+    if (stride == 1) return table[getRowOffset(row) + c];
+    return collapsed[(std::size_t)row * cells.size() + c];
+  }
+
+  int getMaxDist() const { return max_dist; }
+  int getStride() const { return stride; }
+  int getCellsSize() const { return cells.size(); }
+  std::size_t getMemoryUsage() const;
+  int getEvictedCnt() const { return evicted_cnt; }
+};
@@ -15,6 +15,7 @@
  * In 2005 IEEE/RSJ International Conference on Intelligent Robots and Systems
  * (pp. 430–435).
  *
+ * With -S [--sipp], the low-level search is SIPP instead of space-time A*.
  */
 
 #pragma once
@@ -34,8 +35,8 @@ private:
   void run();
 
   // used for tie-break
-  std::vector<bool> table_starts;
-  std::vector<bool> table_goals;
+  StampedArray<bool> table_starts;
+  StampedArray<bool> table_goals;
 
 public:
   HCA(MAPF_Instance* _P);
@@ -1,6 +1,13 @@
-// orientation.hpp
+/*
+ * Orientation of agents and its algebra
+ *
+ * Orientations are ordered counterclockwise by 90 degrees,
+ * the same order as Node::adjacent, so that they are used as indexes.
+ */
+
 #pragma once
-#include <map>
+#include <node.hpp>
+#include <optional>
 
 enum class Orientation {
     X_PLUS,
@@ -8,3 +15,59 @@ enum class Orientation {
     X_MINUS,
     Y_MINUS
 };
+
+constexpr int toIndex(const Orientation dir) { return static_cast<int>(dir); }
+
+constexpr Orientation rotateCounterClockwise(const Orientation dir)
+{
+  return static_cast<Orientation>((toIndex(dir) + 1) % 4);
+}
+
+constexpr Orientation rotateClockwise(const Orientation dir)
+{
+  return static_cast<Orientation>((toIndex(dir) + 3) % 4);
+}
+
+constexpr Orientation getOpposite(const Orientation dir)
+{
+  return static_cast<Orientation>((toIndex(dir) + 2) % 4);
+}
+
+// name used in logs, e.g., "X_PLUS"
+constexpr const char* orientationToString(const Orientation dir)
+{
+  constexpr const char* NAMES[4] = {"X_PLUS", "Y_PLUS", "X_MINUS", "Y_MINUS"};
+  return NAMES[toIndex(dir)];
+}
+
+// degree, X_PLUS = 0
+constexpr int getAngle(const Orientation dir) { return 90 * toIndex(dir); }
+
+// 0, 90 or 180
+constexpr int getAngleDifference(const Orientation dir1,
+                                 const Orientation dir2)
+{
+  const int diff = (toIndex(dir1) - toIndex(dir2) + 4) % 4;
+  return 90 * ((diff == 3) ? 1 : diff);
+}
+
+// neighbor of v in the direction, nullptr if blocked
+inline Node* getAdjacent(const Node* const v, const Orientation dir)
+{
+  return v->adjacent[toIndex(dir)];
+}
+
+// direction of u seen from v, nullopt if not adjacent
+inline std::optional<Orientation> getRelativeOrientation(const Node* const v,
+                                                         const Node* const u)
+{
+  const int dx = u->pos.x - v->pos.x;
+  const int dy = u->pos.y - v->pos.y;
+  int k = -1;
+  if (dy == 0 && dx == 1) k = 0;
+  if (dx == 0 && dy == 1) k = 1;
+  if (dy == 0 && dx == -1) k = 2;
+  if (dx == 0 && dy == -1) k = 3;
+  if (k == -1 || v->adjacent[k] != u) return std::nullopt;
+  return static_cast<Orientation>(k);
+}
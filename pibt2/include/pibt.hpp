@@ -11,7 +11,6 @@
 #pragma once
 #include "solver.hpp"
 #include "orientation.hpp"
-#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -21,52 +20,100 @@ class PIBT : public MAPF_Solver
 public:
   static const std::string SOLVER_NAME;
 
+  // hot-path counters of one timestep, collected always
+  struct Metrics {
+    int funcpibt_calls;
+    int max_depth;      // deepest recursion of priority inheritance
+    int cycles;         // cycles handled by handleCycleWithOrientation
+    int swaps;          // swaps triggered by swap_possible_and_required
+    int push_escapes;   // firings of PushEscapeTrigger
+    int rotations;      // agents turning in place
+    int forward_moves;  // agents moving to other nodes
+    int latency_us;     // planning time of the timestep (microseconds)
+  };
+
+  // details of the whole run, not needed by the metrics log,
+  // counted only with TRACE_LEVEL >= counters (see trace.hpp)
+  struct TraceCounters {
+    long long request_pushes = 0;      // requests appended to the chain
+    long long request_pops = 0;        // requests dropped after failures
+    int max_request_chain = 0;         // longest request chain
+    long long cycle_checks = 0;        // candidates checked for cycles
+    long long blocked_candidates = 0;  // candidates skipped or rejected
+    long long push_escape_checks = 0;  // lookups of push records
+  };
+
 private:
-  // PIBT agent
-  struct Agent {
-    int id;
-    Node* v_now;        // current location
-    Node* v_next;       // next location
-    Node* g;            // goal
-    std::optional<Orientation> ott_now;
-    std::optional<Orientation> ott_next;
-    int elapsed;        // eta
-    int init_d;         // initial distance
-    float tie_breaker;  // epsilon, tie-breaker
-    bool swap_completed;// test:swap
+  // PIBT agents, structure of arrays indexed by agent id
+  struct Agents {
+    Nodes v_now;                        // current location
+    Nodes v_next;                       // next location, nullptr if unplanned
+    Nodes g;                            // goal
+    std::vector<Orientation> ott_now;   // current orientation
+    std::vector<Orientation> ott_next;  // next orientation, valid with v_next
+    std::vector<int> elapsed;           // eta
+    std::vector<int> init_d;            // initial distance
+    std::vector<float> tie_breaker;     // epsilon, tie-breaker
+    std::vector<std::uint32_t> rng;     // state of getRandomXorShift
+    std::vector<char> swap_completed;   // test:swap
   };
-  using Agents = std::vector<Agent*>;
-  
+  Agents A;
+  std::vector<int> order;  // agent ids sorted by priority
+
+  // four neighbors and staying on grids
+  static constexpr int MAX_CANDIDATES = 5;
+
   //
   struct Request {
-    Agent* agent;      
-    Node* requested_node; 
+    int agent;
+    Node* requested_node;
   };
   std::vector<Request> request_chain;
-  bool cycle_detected = false;       
-  bool cycle_handled = false;   
-  Agent* initial_requester = nullptr; 
-  
+  bool cycle_detected = false;
+  bool cycle_handled = false;
+  int initial_requester = NIL;
+
   private:
-  // <node-id, agent>, whether the node is occupied or not
-  // work as reservation table 
-  Agents occupied_now;
-  Agents occupied_next;
+  // <node-id, agent-id>, whether the node is occupied or not (NIL)
+  // work as reservation table, cleared in O(1) at each timestep
+  StampedArray<int> occupied_now;
+  StampedArray<int> occupied_next;
 
   // option
   bool disable_dist_init = false;
+  std::string metrics_format;  // "csv" or "json", empty -> no output
+
+  // metrics
+  Metrics metrics;                    // current timestep
+  std::vector<Metrics> metrics_hist;  // timestep -> metrics
+  int depth = 0;                      // current depth of funcPIBT
+  TraceCounters trace_counters;       // whole run
+  void makeLogMetrics(const std::string& logfile) const;
+
+  // livelock detection by hashing configurations with orientations,
+  // the run stops when at least half of the last livelock_window
+  // configurations already appeared within the window, disabled with zero
+  int livelock_window = 0;
+  int livelock_period = 0;  // detected cycle length, zero for none
+  int livelock_repeats = 0;                     // non-zero periods in window
+  std::vector<std::uint64_t> config_hash_hist;  // [timestep % window]
+  std::vector<int> period_hist;  // [timestep % window], distance to the
+                                 // same configuration, zero for new one
+  // Zobrist key of agent i at (v, o), configurations hash to XOR of keys
+  std::uint64_t getStateHash(const int i, Node* const v,
+                             const Orientation o) const;
+  // register the hash of the configuration at the timestep
+  bool detectLivelock(const std::uint64_t config_hash, const int timestep);
 
   // result of priority inheritance: true -> valid, false -> invalid
-  bool funcPIBT(Agent* ai, Agent* aj = nullptr, bool is_initial = true);
+  bool funcPIBT(const int ai, const int aj = NIL, bool is_initial = true);
 
   // main
   void run();
   
-  // minimal distance to 4 states of goal in cost table
+  // distance from (node, current_dir) to goal in cost table
   float getMinDistToGoal(int agent_id, Node* node, Orientation current_dir);
 
-  // 计算从节点所有可能方向到目标的最小距离
-  float getMinDistAllDirections(int agent_id, Node* node);
 
   // handle cycle
   void handleCycleWithOrientation();
@@ -75,13 +122,21 @@ private:
   std::vector<Node*> reserved_nodes;  // R[i] 表示智能体i预留的节点
 
   //  swap operation
-  Agent* swap_possible_and_required(Agent* ai, const Nodes& C);
+  int swap_possible_and_required(const int ai, const Nodes& C);
   bool is_swap_required(const int pusher, const int puller,
                         Node* v_pusher_origin, Node* v_puller_origin);
   bool is_swap_possible(Node* v_pusher_origin, Node* v_puller_origin);
 
-  // [pushed_agent_id][pusher_id] = push_times
-  std::vector<std::vector<int>> push_count_table;
+  // recent pushers of each agent, a ring buffer of PUSH_HISTORY_SIZE slots
+  // per agent, the oldest pusher is forgotten when a new one comes
+  static constexpr int PUSH_HISTORY_SIZE = 16;
+  struct PushRecord {
+    int pusher;  // NIL for empty
+    int count;   // push_times
+  };
+  std::vector<PushRecord> push_history;  // [pushed_agent_id * SIZE + k]
+  std::vector<int> push_history_head;    // pushed_agent_id -> next slot
+  PushRecord* findPushRecord(int pushed_agent_id, int pusher_id);
   // 更新 push 次数的辅助函数
   void updatePushCount(int pushed_agent_id, int pusher_id);
   // 获取某个智能体被特定智能体push的次数
@@ -97,4 +152,14 @@ public:
 
   void setParams(int argc, char* argv[]);
   static void printHelp();
+
+  void makeLog(const std::string& logfile = "./result.txt") override;
+  void makeLogBasicInfo(std::ostream& log) override;
+  void setLivelockWindow(const int window) { livelock_window = window; }
+  int getLivelockPeriod() const { return livelock_period; }
+  // e.g., result.txt -> result_metrics.csv
+  static std::string getMetricsFileName(const std::string& logfile,
+                                        const std::string& format);
+  const std::vector<Metrics>& getMetrics() const { return metrics_hist; }
+  const TraceCounters& getTraceCounters() const { return trace_counters; }
 };
@@ -11,6 +11,10 @@ private:
   // time required to complement plan, default zero
   double comp_time_complement;
 
+  // hand off to Push & Swap when PIBT livelocks, disabled with zero
+  int livelock_window;
+  int livelock_period;  // detected by PIBT, zero for none
+
 public:
   static const std::string SOLVER_NAME;
 
@@ -20,6 +24,7 @@ public:
   PIBT_PLUS(MAPF_Instance* _P);
   ~PIBT_PLUS() {}
 
-  void makeLog(const std::string& logfile);
+  void makeLogBasicInfo(std::ostream& log) override;
+  void setParams(int argc, char* argv[]);
   static void printHelp();
 };
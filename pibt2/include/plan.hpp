@@ -9,6 +9,14 @@
 
 /*
  * array of configurations
+ *
+ * - stored as rows of node ids (int) and orientations (2 bits per agent),
+ *   a row is accessible without copy by getNodeIds/getPackedOrientations
+ * - with setKeyframeInterval(k), rows are kept only every k timesteps and
+ *   other timesteps keep agents that moved or turned (delta layer),
+ *   such rows are restored into a Cursor owned by the caller, so that
+ *   row accessors share no mutable state and threads can scan a plan
+ * - path costs and sum of costs are updated when configurations are added
  */
 // 测试：动作序列
 struct Action {
@@ -20,16 +28,111 @@ struct Action {
 using ActionSequence = std::vector<Action>;
 
 struct Plan {
+public:
+  // row restored from the delta layer, each thread uses its own cursor;
+  // moving forward from the restored timestep applies only the changes
+  // in between, valid for one plan until it is cleared
+  struct Cursor {
+    std::vector<int> ids;
+    std::vector<std::uint8_t> otts;
+    int t = -1;  // restored timestep, -1 for none
+  };
+
 private:
-  Configs configs;  // main
-  std::vector<std::vector<Orientation>> orientations;  
-  Orientation rotateCounterClockwise(Orientation orient) const;
+  int num_agents = 0;         // fixed by the first configuration
+  int plan_size = 0;          // number of configurations
+  int orientation_bytes = 0;  // bytes of orientations per row
+  std::vector<Node*> nodes;   // node id -> node, collected from configs
+
+  // rows of every timestep, or of keyframes with the delta layer
+  int keyframe_interval = 0;              // zero without delta layer
+  std::vector<int> node_ids;              // [row * num_agents + i]
+  std::vector<std::uint8_t> packed_otts;  // [row * orientation_bytes + i/4]
+
+  // delta layer, changes of timestep t are sorted by agents,
+  // changes[change_offsets[t]], ..., changes[change_offsets[t + 1] - 1]
+  struct Change {
+    std::uint32_t agent_ott;  // agent id << 2 | orientation
+    int node_id;
+  };
+  std::vector<Change> changes;
+  std::vector<int> change_offsets;
+  std::vector<int> last_ids;  // last row, always materialized
+  std::vector<std::uint8_t> last_otts;
+
+  // incremental costs
+  std::vector<int> arrivals;  // agent -> timestep of the last move
+  int soc = 0;
+
+  // all configurations are added with orientations
+  bool oriented = false;
+
+  bool isKeyframe(const int t) const
+  {
+    return keyframe_interval == 0 || t % keyframe_interval == 0;
+  }
+  // whether the row of t is kept, i.e., a keyframe or the last row
+  bool isStored(const int t) const
+  {
+    return isKeyframe(t) || t == plan_size - 1;
+  }
+  const int* storedIds(const int t) const;
+  const std::uint8_t* storedOtts(const int t) const;
+  // the latest change of agent i within (keyframe, t], nullptr for none
+  const Change* findChange(const int t, const int i) const;
+
+  // validate timesteps [t_from, t_to), return the first invalid timestep
+  // with a message, or t_to if valid
+  int validateRange(const int t_from, const int t_to, std::string& msg) const;
+
+  Node* toNode(const int id) const { return (id < 0) ? nullptr : nodes[id]; }
+  static Orientation unpack(const std::uint8_t* otts, const int i)
+  {
+    return static_cast<Orientation>((otts[i >> 2] >> ((i & 3) << 1)) & 3);
+  }
+  static void pack(std::uint8_t* otts, const int i, const int o)
+  {
+    const int shift = (i & 3) << 1;
+    otts[i >> 2] = (otts[i >> 2] & ~(3 << shift)) | (o << shift);
+  }
+  // append a configuration, orients == nullptr -> default orientations
+  void append(const Node* const* c, const int c_size,
+              const Orientation* orients);
+  void checkTimestep(const int t) const;
+  void restoreRow(const int t, Cursor& cursor) const;
 
   std::vector<std::unordered_map<int, ActionSequence>> action_tables;  // 测试：[timestep][agent_id]
 
+  // node id -> consecutive occupancy [lo, hi] of agents, sorted by time,
+  // built lazily up to indexed_size configs for getMaxConstraintTime
+  struct Occupancy {
+    int lo;
+    int hi;
+    int agent;
+  };
+  mutable std::unordered_map<int, std::vector<Occupancy>> occupancy_index;
+  mutable int indexed_size = 0;
+  void updateOccupancyIndex() const;
+
 public:
   ~Plan() {}
 
+  // keep rows every k timesteps and changes of agents otherwise,
+  // zero for rows of all timesteps, only for an empty plan
+  void setKeyframeInterval(const int k);
+  int getKeyframeInterval() const { return keyframe_interval; }
+
+  // timestep -> node ids of agents (nullptr -> -1), without copy,
+  // valid until the plan is modified or the cursor is moved;
+  // rows not stored with the delta layer need a cursor
+  Span<const int> getNodeIds(const int t) const;
+  Span<const int> getNodeIds(const int t, Cursor& cursor) const;
+  // timestep -> orientations, 2 bits per agent, agent i at bits 2*(i%4)
+  // of byte i/4
+  Span<const std::uint8_t> getPackedOrientations(const int t) const;
+  Span<const std::uint8_t> getPackedOrientations(const int t,
+                                                 Cursor& cursor) const;
+
   // timestep -> configuration
   Config get(const int t) const;
 
@@ -98,10 +201,15 @@ public:
   void operator+=(const Plan& other);
 
   // check the plan is valid or not
-  bool validate(MAPF_Instance* P) const;
-  bool validate(MAPD_Instance* P) const;
-  bool validate(const Config& starts, const Config& goals) const;
-  bool validate(const Config& starts) const;
+  // O(makespan * agents), timesteps are checked in parallel,
+  // orientations are checked when the plan has them:
+  // wait, rotate by 90 degrees, or move forward in the facing direction
+  bool validate(MAPF_Instance* P, const int num_threads = 1) const;
+  bool validate(MAPD_Instance* P, const int num_threads = 1) const;
+  bool validate(const Config& starts, const Config& goals,
+                const int num_threads = 1) const;
+  bool validate(const Config& starts, const int num_threads = 1) const;
+  bool hasOrientations() const { return oriented; }
 
   // when updating a single path,
   // the path should be longer than this value to avoid conflicts
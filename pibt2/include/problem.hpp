@@ -50,7 +50,15 @@ protected:
 
 public:
   Problem(){};
-  Problem(const std::string& _instance) : instance(_instance) {}
+  Problem(const std::string& _instance)
+      : instance(_instance),
+        G(nullptr),
+        MT(nullptr),
+        num_agents(0),
+        max_timestep(0),
+        max_comp_time(0)
+  {
+  }
   Problem(std::string _instance, Graph* _G, std::mt19937* _MT, Config _config_s,
           Config _config_g, int _num_agents, int _max_timestep,
           int _max_comp_time);
@@ -23,16 +23,18 @@ private:
 
   // used in occupancy
   static constexpr int NIL = -1;
+  StampedArray<int> tmp_occupied_now;  // used in swap operation
+  StampedArray<bool> closed;           // used in getNearestEmptyNode
 
   // main
   void run();
 
   // push operation
-  bool push(Plan& plan, const int i, Nodes& U, std::vector<int>& occupied_now);
+  bool push(Plan& plan, const int i, Nodes& U, StampedArray<int>& occupied_now);
 
   // swap operation
-  bool swap(Plan& plan, const int i, Nodes& U, std::vector<int>& occupied_now);
-  bool swap(Plan& plan, const int i, Nodes& U, std::vector<int>& occupied_now,
+  bool swap(Plan& plan, const int i, Nodes& U, StampedArray<int>& occupied_now);
+  bool swap(Plan& plan, const int i, Nodes& U, StampedArray<int>& occupied_now,
             std::vector<int>& recursive_list);
 
   // improve solution quality, see
@@ -43,43 +45,43 @@ private:
 
   // push several agents simultaneously
   bool multiPush(Plan& plan, const int r, const int s, const Path& p,
-                 std::vector<int>& occupied_now);
+                 StampedArray<int>& occupied_now);
 
   // clear operation
   bool clear(Plan& plan, Node* v, const int r, const int s,
-             std::vector<int>& occupied_now);
+             StampedArray<int>& occupied_now);
 
   // execute swap operation
   void executeSwap(Plan& plan, const int r, const int s,
-                   std::vector<int>& occupied_now);
+                   StampedArray<int>& occupied_now);
 
   // resolve operation
   bool resolve(Plan& plan, const int r, const int s, Nodes& U,
-               std::vector<int>& occupied_now);
+               StampedArray<int>& occupied_now);
 
   // ---------------------------------------
   // utilities
 
   // get nearest empty location
-  Node* getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
+  Node* getNearestEmptyNode(Node* v, StampedArray<int>& occupied_now,
                             const Nodes& obs);
 
   // get the shortest path towards goals
-  Path getShortestPath(const int id, Node* s, std::vector<int>& occupied_now);
+  Path getShortestPath(const int id, Node* s, StampedArray<int>& occupied_now);
 
   // push toward empty node
-  bool pushTowardEmptyNode(Node* v, Plan& plan, std::vector<int>& occupied_now,
+  bool pushTowardEmptyNode(Node* v, Plan& plan, StampedArray<int>& occupied_now,
                            const Nodes& obs);
 
   // update plan
   void updatePlan(const int id, Node* next_node, Plan& plan,
-                  std::vector<int>& occupied_now);
+                  StampedArray<int>& occupied_now);
 
   // get all vertices of degree >= 3 on G
   void findNodesWithManyNeighbors();
 
   // error check
-  void checkConsistency(Plan& plan, std::vector<int>& occupied_now);
+  void checkConsistency(Plan& plan, StampedArray<int>& occupied_now);
 
 public:
   PushAndSwap(MAPF_Instance* _P);
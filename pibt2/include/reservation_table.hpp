@@ -0,0 +1,70 @@
+/*
+ * Reservation table of paths, sparse over time
+ *
+ * - each node keeps sorted, disjoint occupancy intervals [lo, hi] of agents,
+ *   so memory is proportional to the number of moves instead of
+ *   makespan x nodes
+ * - consecutive timesteps of one agent at one node are merged
+ * - a path can be reserved forever at its last node (agent stays at goal)
+ * - point and swap-conflict queries are binary searches, O(log k)
+ * - paths of single agents are inserted and removed incrementally
+ */
+
+#pragma once
+#include <graph.hpp>
+
+#include "sipp.hpp"
+
+class ReservationTable
+{
+public:
+  static constexpr int NIL = -1;
+  static constexpr int INF = SIPP::INF;
+
+private:
+  struct Reservation {
+    int lo;     // first timestep
+    int hi;     // last timestep, INF for forever
+    int agent;  // occupying agent
+  };
+  using Reservations = std::vector<Reservation>;
+
+  std::vector<Reservations> table;  // node id -> reservations
+  Nodes used_nodes;                 // nodes with reservations, used to clear
+  std::vector<bool> used;           // node id -> in used_nodes
+
+  // first reservation with hi >= t
+  static Reservations::const_iterator lowerBound(const Reservations& R,
+                                                 const int t);
+
+public:
+  ReservationTable(const int nodes_size);
+  ~ReservationTable() {}
+
+  // occupy v during [lo, hi] by the agent, overwrite others
+  void insert(Node* const v, const int lo, const int hi, const int agent);
+  // release v during [lo, hi] if occupied by the agent
+  void remove(Node* const v, const int lo, const int hi, const int agent);
+
+  // path[t] is occupied at t_offset + t,
+  // with stay_forever, the last node is occupied after the path ends
+  void insert(const Path& path, const int agent, const int t_offset = 0,
+              const bool stay_forever = false);
+  void remove(const Path& path, const int agent, const int t_offset = 0,
+              const bool stay_forever = false);
+  void clear();
+
+  // agent occupying v at t, NIL if free
+  int get(Node* const v, const int t) const;
+  // latest timestep until t_max when v is occupied by an agent
+  // other than the given one, NIL if not found
+  int getLatestTime(Node* const v, const int agent, const int t_max) const;
+  // whether the move from -> to arriving at t swaps with someone
+  bool isSwapConflict(Node* const from, Node* const to, const int t) const;
+  // safe intervals of v after t_start, relative to t_start,
+  // occupancy at t_start itself is ignored
+  void getSafeIntervals(Node* const v, const int t_start,
+                        SIPP::Intervals& out) const;
+
+  int getReservationsSize() const;
+};
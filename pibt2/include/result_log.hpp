@@ -0,0 +1,176 @@
+/*
+ * Binary result log, seekable and much smaller than the text log
+ *
+ * - a row is a timestep: locations and orientations of agents,
+ *   with targets and tasks for MAPD
+ * - every keyframe_interval timesteps a row keeps all agents (keyframe),
+ *   other rows keep only agents that changed; moves to a neighbor and
+ *   orientations are packed into one byte, others are varints
+ * - the index keeps the offset of every row, hence a row is decoded from
+ *   the preceding keyframe
+ * - the preamble is the text log before the rows, e.g., basic info,
+ *   starts, goals, "solution=", so that it is converted to the text log
+ * - rows are encoded on the caller and written by a background thread,
+ *   the preamble is given at the end, so rows can be appended while solving
+ *
+ * format: Header, rows, index (uint64 x (timesteps + 1)), preamble, Footer
+ */
+
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "orientation.hpp"
+
+enum class LogFormat { TEXT, BINARY };
+
+class ResultLog
+{
+public:
+  enum class Kind : std::uint32_t { MAPF = 0, MAPD = 1 };
+  static constexpr int DEFAULT_KEYFRAME_INTERVAL = 64;
+
+  // decoded row
+  struct Row {
+    std::vector<int> node_ids;      // location, y * width + x
+    std::vector<Orientation> otts;  // orientation
+    std::vector<int> target_ids;    // MAPD only
+    std::vector<int> task_ids;      // MAPD only, Task::NIL for no task
+  };
+
+protected:
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    Kind kind;
+    std::uint32_t agents;
+    std::uint32_t width;
+    std::uint32_t keyframe_interval;
+    std::uint32_t reserved;
+  };
+  struct Footer {
+    std::uint64_t timesteps;
+    std::uint64_t index_offset;
+    std::uint64_t preamble_offset;
+    char magic[8];
+  };
+  static constexpr char MAGIC[8] = "PIBTLOG";
+  static constexpr std::uint32_t VERSION = 1;
+
+  // row codes, move (3 bits) << 2 | orientation (2 bits)
+  enum Move : std::uint8_t { STAY, X_PLUS, Y_PLUS, X_MINUS, Y_MINUS, JUMP };
+  static constexpr std::uint8_t TARGET_CHANGED = 1 << 5;
+  static constexpr std::uint8_t TASK_CHANGED = 1 << 6;
+};
+
+class ResultLogWriter : public ResultLog
+{
+private:
+  static constexpr std::size_t CHUNK_SIZE = 1 << 20;  // bytes to flush
+  static constexpr std::size_t MAX_CHUNKS = 8;        // waiting chunks
+
+  const std::string file;
+  const Kind kind;
+  const int num_agents;
+  const int width;
+  const int keyframe_interval;
+  std::ofstream out;
+  bool closed;
+
+  // encoding
+  int timesteps;
+  std::uint64_t written;          // bytes passed to the background thread
+  std::vector<std::uint8_t> buf;  // current chunk
+  std::vector<std::uint64_t> offsets;
+  Row prev;  // last row
+
+  // background thread
+  std::thread worker;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::deque<std::vector<std::uint8_t>> chunks;  // waiting to be written
+  bool finishing;
+
+  void flush();
+  void writeChunks();
+  void putVarint(std::uint64_t x);
+  void halt(const std::string& msg) const;
+
+public:
+  ResultLogWriter(const std::string& _file, const Kind _kind,
+                  const int _num_agents, const int _width,
+                  const int _keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+  ~ResultLogWriter();
+
+  // add the next timestep, arrays of size num_agents,
+  // orientations are 2 bits per agent as Plan::getPackedOrientations,
+  // targets and tasks are only for MAPD
+  void append(const int* node_ids, const std::uint8_t* packed_otts,
+              const int* target_ids = nullptr,
+              const int* task_ids = nullptr);
+
+  // write the index and the preamble, then close the file
+  void close(const std::string& preamble);
+
+  int getTimesteps() const { return timesteps; }
+};
+
+class ResultLogReader : public ResultLog
+{
+private:
+  const std::string file;
+  void* data;
+  std::size_t data_size;
+  const std::uint8_t* bytes;
+  const Header* header;
+  const std::uint8_t* index;  // offsets of timesteps, the end follows
+  int timesteps;
+  std::string preamble;
+
+  std::uint64_t getOffset(const int t) const;
+  void resize(Row& row) const;
+  void decode(const std::uint8_t*& p, const bool keyframe, Row& row) const;
+  void halt(const std::string& msg) const;
+
+public:
+  ResultLogReader(const std::string& _file);
+  ~ResultLogReader();
+
+  Kind getKind() const { return header->kind; }
+  int getNumAgents() const { return header->agents; }
+  int getWidth() const { return header->width; }
+  int getKeyframeInterval() const { return header->keyframe_interval; }
+  int getTimesteps() const { return timesteps; }
+  const std::string& getPreamble() const { return preamble; }
+
+  // decode timestep t from the preceding keyframe
+  void read(const int t, Row& row) const;
+
+  // decode timesteps [t_from, t_to) in order, func(t, row)
+  template <typename F>
+  void read(const int t_from, int t_to, F&& func) const
+  {
+    t_to = std::min(t_to, timesteps);
+    if (t_from >= t_to) return;
+    Row row;
+    read(t_from, row);
+    func(t_from, row);
+    const std::uint8_t* p = bytes + getOffset(t_from + 1);
+    for (int t = t_from + 1; t < t_to; ++t) {
+      decode(p, t % header->keyframe_interval == 0, row);
+      func(t, row);
+    }
+  }
+
+  // write the text log, same as MAPF_Solver/MAPD_Solver::makeLog
+  void toText(std::ostream& os) const;
+
+  static bool isBinary(const std::string& file);
+};
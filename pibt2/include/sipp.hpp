@@ -0,0 +1,182 @@
+/*
+ * Safe Interval Path Planning (SIPP)
+ *
+ * - a search state is (node, safe interval), an interval is a maximal
+ *   contiguous period in which the node is not occupied by others
+ * - waiting is folded into moves, so expansions scale with the number of
+ *   intervals instead of the number of timesteps
+ * - safe intervals are requested from the caller when a node is reached for
+ *   the first time in a search, times are relative to the start (= 0)
+ *
+ * - ref
+ * Phillips, M., & Likhachev, M. (2011).
+ * SIPP: Safe interval path planning for dynamic environments.
+ * In 2011 IEEE International Conference on Robotics and Automation
+ * (pp. 5628–5635).
+ */
+
+#pragma once
+#include <limits>
+
+#include "space_time_astar.hpp"
+
+class SIPP
+{
+public:
+  static constexpr int INF = std::numeric_limits<int>::max();
+
+  struct Interval {
+    int lo;  // first safe timestep
+    int hi;  // last safe timestep, INF if safe forever
+  };
+  using Intervals = std::vector<Interval>;
+
+  // g is the arrival time, compatible with space-time A*
+  struct SippNode : public SpaceTimeAstar::AstarNode {
+    int interval;  // index of the interval in this search
+  };
+
+private:
+  NodeArena<SippNode> arena;
+  std::vector<SippNode*> OPEN;  // binary heap
+
+  // intervals of node v are intervals[first[v], last[v]),
+  // valid only when stamp[v] equals the current search
+  std::vector<int> stamp;
+  std::vector<int> first;
+  std::vector<int> last;
+  int search_cnt;
+  Intervals intervals;
+  std::vector<int> earliest;  // interval -> earliest arrival found
+
+  void reset(const int nodes_size);
+
+  template <typename GetSafeIntervals>
+  void prepareIntervals(Node* const v, GetSafeIntervals&& getSafeIntervals)
+  {
+    if (stamp[v->id] == search_cnt) return;
+    stamp[v->id] = search_cnt;
+    first[v->id] = intervals.size();
+    getSafeIntervals(v, intervals);
+    last[v->id] = intervals.size();
+    earliest.resize(intervals.size(), INF);
+  }
+
+public:
+  SIPP();
+  ~SIPP() {}
+
+  // remove [lo, hi] from sorted intervals I[from, ...)
+  static void block(Intervals& I, const std::size_t from, const int lo,
+                    const int hi);
+
+  /*
+   * find a path s -> g, which stays at g from min_fin_time or later
+   *
+   * fValue(AstarNode*) -> int
+   * compare(AstarNode* a, AstarNode* b) -> true if b is expanded first
+   * getSafeIntervals(Node* v, Intervals& out) -> append sorted safe
+   *   intervals of v, occupancy at time 0 is ignored
+   * checkInvalidMove(Node* from, Node* to, int t) -> true if the move
+   *   arriving at t collides with others, e.g., swap conflicts
+   * max_time: upper bound of arrival times, -1 for unbounded
+   * failed or time limit exceeded -> return {}
+   */
+  template <typename FValue, typename Compare, typename GetSafeIntervals,
+            typename CheckInvalidMove>
+  Path search(Node* const s, Node* const g, const int min_fin_time,
+              const int nodes_size, FValue&& fValue, Compare&& compare,
+              GetSafeIntervals&& getSafeIntervals,
+              CheckInvalidMove&& checkInvalidMove, const int max_time = -1,
+              const int time_limit = -1);
+};
+
+template <typename FValue, typename Compare, typename GetSafeIntervals,
+          typename CheckInvalidMove>
+Path SIPP::search(Node* const s, Node* const g, const int min_fin_time,
+                  const int nodes_size, FValue&& fValue, Compare&& compare,
+                  GetSafeIntervals&& getSafeIntervals,
+                  CheckInvalidMove&& checkInvalidMove, const int max_time,
+                  const int time_limit)
+{
+  auto t_start = Time::now();
+  reset(nodes_size);
+  const int t_max = (max_time < 0) ? INF : max_time;
+
+  auto push = [&](SippNode* n) {
+    OPEN.push_back(n);
+    std::push_heap(OPEN.begin(), OPEN.end(), compare);
+  };
+
+  // initial node
+  prepareIntervals(s, getSafeIntervals);
+  if (first[s->id] == last[s->id] || intervals[first[s->id]].lo > 0) return {};
+  SippNode* n = arena.peek();
+  n->v = s;
+  n->g = 0;
+  n->p = nullptr;
+  n->interval = first[s->id];
+  n->f = fValue(n);
+  arena.commit();
+  earliest[n->interval] = 0;
+  push(n);
+
+  // main loop
+  int fin_time = -1;
+  while (!OPEN.empty()) {
+    // check time limit
+    if (time_limit > 0 && getElapsedTime(t_start) > time_limit) break;
+
+    // minimum node
+    std::pop_heap(OPEN.begin(), OPEN.end(), compare);
+    n = OPEN.back();
+    OPEN.pop_back();
+
+    // a better arrival has been found
+    if (n->g > earliest[n->interval]) continue;
+
+    // check goal condition, the agent must be able to stay at the goal
+    const int hi = intervals[n->interval].hi;
+    if (n->v == g && hi == INF && std::max(n->g, min_fin_time) <= t_max) {
+      fin_time = std::max(n->g, min_fin_time);
+      break;
+    }
+
+    // expand, the agent can wait until hi
+    const int t_leave_max = (hi == INF) ? INF : hi + 1;
+    for (auto u : n->v->neighbor) {
+      prepareIntervals(u, getSafeIntervals);
+      for (int j = first[u->id]; j < last[u->id]; ++j) {
+        const auto& I = intervals[j];
+        if (I.lo > t_leave_max) break;
+        if (I.hi <= n->g) continue;
+        const int t_end = std::min({I.hi, t_leave_max, t_max});
+        int t = std::max(n->g + 1, I.lo);
+        while (t <= t_end && checkInvalidMove(n->v, u, t)) ++t;
+        if (t > t_end || t >= earliest[j]) continue;
+        earliest[j] = t;
+
+        SippNode* m = arena.peek();
+        m->v = u;
+        m->g = t;
+        m->p = n;
+        m->interval = j;
+        m->f = fValue(m);
+        arena.commit();
+        push(m);
+      }
+    }
+  }
+
+  Path path;
+  if (fin_time >= 0) {  // success
+    // fill waiting
+    for (int t_end = fin_time; n != nullptr;
+         n = static_cast<SippNode*>(n->p)) {
+      for (int t = t_end; t >= n->g; --t) path.push_back(n->v);
+      t_end = n->g - 1;
+    }
+    std::reverse(path.begin(), path.end());
+  }
+  return path;
+}
@@ -10,10 +10,15 @@
 #include <cmath>
 #include <optional>
 
+#include "distance_table.hpp"
 #include "paths.hpp"
 #include "orientation.hpp"
 #include "plan.hpp"
 #include "problem.hpp"
+#include "reservation_table.hpp"
+#include "result_log.hpp"
+#include "sipp.hpp"
+#include "space_time_astar.hpp"
 #include "util.hpp"
 
 class MinimumSolver
@@ -34,6 +39,11 @@ private:
 protected:
   bool verbose;    // true -> print additional info
   bool log_short;  // true -> cannot visualize the result, default: false
+  LogFormat log_format;  // text (default) or binary, see result_log.hpp
+  // binary log written while solving, see setLogFile
+  std::string log_file;
+  std::unique_ptr<ResultLogWriter> log_writer;
+  int log_rows;  // timesteps of the solution passed to log_writer
 
   // -------------------------------
   // utilities for time
@@ -62,6 +72,12 @@ public:
   virtual void setParams(int argc, char* argv[]){};
   void setVerbose(bool _verbose) { verbose = _verbose; }
   void setLogShort(bool _log_short) { log_short = _log_short; }
+  void setLogFormat(LogFormat _log_format) { log_format = _log_format; }
+  // with the binary format, solve() opens the file and timesteps are
+  // appended as they are committed, makeLog with the same file adds the rest
+  void setLogFile(const std::string& _log_file) { log_file = _log_file; }
+  // store the solution with the delta layer, see Plan::setKeyframeInterval
+  void setKeyframeInterval(const int k) { solution.setKeyframeInterval(k); }
 
   // -------------------------------
   // print help
@@ -119,38 +135,57 @@ protected:
     }
   
   // space-time A*
-  struct AstarNode {
-    Node* v;           // location
-    int g;             // time
-    int f;             // f-value
-    AstarNode* p;      // parent
-    std::string name;  // name
-    AstarNode(Node* _v, int _g, int _f, AstarNode* _p);
-    static std::string getName(Node* _v, int _g);
-  };
+  using AstarNode = SpaceTimeAstar::AstarNode;
   using CompareAstarNode = std::function<bool(AstarNode*, AstarNode*)>;
   using CheckAstarFin = std::function<bool(AstarNode*)>;
   using CheckInvalidAstarNode = std::function<bool(AstarNode*)>;
   using AstarHeuristics = std::function<int(AstarNode*)>;
   using AstarNodes = std::vector<AstarNode*>;
+
+private:
+  SpaceTimeAstar astar;  // search engines, their memory is reused
+  SIPP sipp;
+
+protected:
   /*
-   * Template of Space-Time A*.
-   * See the following reference.
-   *
-   * Cooperative Pathﬁnding.
-   * D. Silver.
-   * AI Game Programming Wisdom 3, pages 99–111, 2006.
+   * Template of Space-Time A*, see space_time_astar.hpp.
+   * Callbacks are taken as template parameters, pass lambdas to inline them.
    */
-  static Path getPathBySpaceTimeAstar(
-      Node* const s,                 // start
-      Node* const g,                 // goal
-      AstarHeuristics& fValue,       // func: f-value
-      CompareAstarNode& compare,     // func: compare two nodes
-      CheckAstarFin& checkAstarFin,  // func: check goal
-      CheckInvalidAstarNode&
-          checkInvalidAstarNode,  // func: check invalid nodes
-      const int time_limit = -1   // time limit
-  );
+  template <typename FValue, typename Compare, typename CheckFin,
+            typename CheckInvalid>
+  Path getPathBySpaceTimeAstar(
+      Node* const s,                         // start
+      Node* const g,                         // goal
+      FValue&& fValue,                       // func: f-value
+      Compare&& compare,                     // func: compare two nodes
+      CheckFin&& checkAstarFin,              // func: check goal
+      CheckInvalid&& checkInvalidAstarNode,  // func: check invalid nodes
+      const int time_limit = -1              // time limit
+  )
+  {
+    return astar.search(s, fValue, compare, checkAstarFin,
+                        checkInvalidAstarNode, time_limit);
+  }
+
+  // SIPP, see sipp.hpp, the path stays at g from min_fin_time or later
+  template <typename FValue, typename Compare, typename GetSafeIntervals,
+            typename CheckInvalidMove>
+  Path getPathBySIPP(
+      Node* const s,                          // start
+      Node* const g,                          // goal
+      const int min_fin_time,                 // earliest time to finish
+      FValue&& fValue,                        // func: f-value
+      Compare&& compare,                      // func: compare two nodes
+      GetSafeIntervals&& getSafeIntervals,    // func: safe intervals
+      CheckInvalidMove&& checkInvalidMove,    // func: check invalid moves
+      const int max_time = -1,                // upper bound of timesteps
+      const int time_limit = -1               // time limit
+  )
+  {
+    return sipp.search(s, g, min_fin_time, G->getNodesSize(), fValue, compare,
+                       getSafeIntervals, checkInvalidMove, max_time,
+                       time_limit);
+  }
   // typical functions
   static CompareAstarNode compareAstarNodeBasic;
 
@@ -189,9 +224,13 @@ private:
 
   // distance to goal
 protected:
-  using DistanceTable = std::vector<std::vector<int>>;  // [agent][node_id]
-  DistanceTable distance_table;                         // distance table
+  std::unique_ptr<DistanceTable> distance_table;  // distance table
   DistanceTable* distance_table_p;  // pointer, used in nested solvers
+  std::vector<int> distance_rows;   // agent -> row of distance table
+  int num_threads;                  // used to create distance table
+  bool lazy_distance;               // compute rows on demand
+  std::size_t distance_memory_budget;  // for lazy mode, byte, 0: unlimited
+  bool use_distance_cache;          // reuse rows stored next to the map
 
   std::vector<std::vector<int>> basic_distance_table;
 
@@ -229,8 +268,13 @@ public:
   virtual void makeLog(const std::string& logfile = "./result.txt");
 
 protected:
-  virtual void makeLogBasicInfo(std::ofstream& log);
-  virtual void makeLogSolution(std::ofstream& log);
+  virtual void makeLogBasicInfo(std::ostream& log);
+  virtual void makeLogInstance(std::ostream& log);
+  virtual void makeLogSolution(std::ostream& log);
+  // rows not yet appended while solving are written, then the preamble
+  virtual void makeLogBinary(const std::string& logfile);
+  void openLog();    // at the start of solve, with setLogFile
+  void appendLog();  // committed timesteps of the solution, if opened
 
   // -------------------------------
   // params
@@ -250,6 +294,8 @@ public:
   int pathDist(Node* const s, Node* const g) const { return G->pathDist(s, g); }
   int pathDist(const int i,
                Node* const s) const;  // get path distance between s -> g_i
+  // minimum over orientations at s, one lookup in the collapsed row
+  int pathDistAnyDir(const int i, Node* const s) const;
   int pathDist(const int i) const;    // get path distance between s_i -> g_i
   // get path distance with orientation
   int pathDist(const int i, Node* const s, Orientation dir) const;
@@ -261,12 +307,23 @@ public:
   }  // used in nested solvers
 
   void createDistanceTableWithOrientation();  // compute distance table with orientation
-  
+  void setNumThreads(int _num_threads) { num_threads = _num_threads; }
+  // memory budget in MB, zero for unlimited
+  void setLazyDistanceTable(int budget_mb)
+  {
+    lazy_distance = true;
+    distance_memory_budget = (std::size_t)budget_mb << 20;
+  }
+  void setUseDistanceCache(bool flg) { use_distance_cache = flg; }
+
   int pathDistWithOrientation(const int i, Node* const s, Orientation dir) const {
-      if (distance_table_p != nullptr) {
-          return distance_table_p->operator[](i)[s->id * 4 + static_cast<int>(dir)];
-      }
-      return distance_table[i][s->id * 4 + static_cast<int>(dir)];
+      return pathDist(i, s, dir);
+  }
+  // table in use, own or given by the parent solver
+  DistanceTable* getDistanceTable() const
+  {
+    return (distance_table_p != nullptr) ? distance_table_p
+                                         : distance_table.get();
   }
 
   static int getStateIndex(Node* node, Orientation dir) {
@@ -301,7 +358,8 @@ protected:
   void updatePathTableWithoutClear(const int id, const Path& p,
                                    const Paths& paths);
   static constexpr int NIL = -1;
-  std::vector<std::vector<int>> PATH_TABLE;
+  ReservationTable PATH_TABLE;  // agents stay at their goals after paths
+  bool use_sipp;  // low-level search of prioritized planning, SIPP or A*
 
 public:
   MAPF_Solver(MAPF_Instance* _P);
@@ -329,21 +387,32 @@ public:
   virtual void makeLog(const std::string& logfile = "./result.txt");
 
 protected:
-  virtual void makeLogBasicInfo(std::ofstream& log);
-  virtual void makeLogSolution(std::ofstream& log);
+  virtual void makeLogBasicInfo(std::ostream& log);
+  virtual void makeLogInstance(std::ostream& log);
+  virtual void makeLogSolution(std::ostream& log);
+  // rows not yet appended while solving are written, then the preamble
+  virtual void makeLogBinary(const std::string& logfile);
+  void openLog();    // at the start of solve, with setLogFile
+  void appendLog();  // committed timesteps of the solution, if opened
 
   // -------------------------------
   // distance
 protected:
   bool use_distance_table;
-  int preprocessing_comp_time;                          // computation time
-  using DistanceTable = std::vector<std::vector<int>>;  // [node_id][node_id]
-  DistanceTable distance_table;                         // distance table
+  bool use_distance_cache;  // reuse distance table stored next to the map
+  int num_threads;          // used to create distance table
+  int preprocessing_comp_time;  // computation time
+  // BFS from endpoints (all cells if not specified), [target][cell]
+  std::unique_ptr<DistanceTable> distance_table;
   int pathDist(Node* const s, Node* const g) const;
 
 private:
   void createDistanceTable();
 
+public:
+  void setNumThreads(int _num_threads) { num_threads = _num_threads; }
+  void setUseDistanceCache(bool flg) { use_distance_cache = flg; }
+
   // -------------------------------
   // metric
 public:
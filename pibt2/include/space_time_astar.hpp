@@ -0,0 +1,174 @@
+/*
+ * Space-time A* engine
+ *
+ * - a state (node, time) is packed into one 64-bit key
+ * - the closed set is an open-addressing hash set of keys
+ * - search nodes are taken from an arena, which is kept across searches
+ * - f-value, goal condition and constraints are template parameters,
+ *   so that they are inlined into the main loop
+ *
+ * See the following reference.
+ *
+ * Cooperative Pathﬁnding.
+ * D. Silver.
+ * AI Game Programming Wisdom 3, pages 99–111, 2006.
+ */
+
+#pragma once
+#include <graph.hpp>
+#include <cstdint>
+#include <memory>
+
+#include "util.hpp"
+
+// bump allocator of search nodes,
+// fixed-size chunks are kept and reused after clear
+template <typename T>
+class NodeArena
+{
+private:
+  static constexpr std::size_t CHUNK_SIZE = 4096;
+  std::vector<std::unique_ptr<T[]>> chunks;
+  std::size_t used;  // number of nodes handed out
+
+public:
+  NodeArena() : used(0) {}
+
+  // next free node, not handed out until commit
+  T* peek()
+  {
+    if (used == chunks.size() * CHUNK_SIZE) {
+      chunks.emplace_back(new T[CHUNK_SIZE]);
+    }
+    return &chunks[used / CHUNK_SIZE][used % CHUNK_SIZE];
+  }
+  void commit() { ++used; }
+  void clear() { used = 0; }
+};
+
+class SpaceTimeAstar
+{
+public:
+  struct AstarNode {
+    Node* v;       // location
+    int g;         // time
+    int f;         // f-value
+    AstarNode* p;  // parent
+  };
+
+  using Key = std::uint64_t;
+  static Key getKey(Node* const v, const int g)
+  {
+    return ((Key)(std::uint32_t)v->id << 32) | (std::uint32_t)g;
+  }
+
+private:
+  NodeArena<AstarNode> arena;
+
+  // closed set with linear probing, capacity is a power of two
+  static constexpr Key EMPTY = ~(Key)0;
+  std::vector<Key> closed;
+  std::vector<std::size_t> closed_slots;  // occupied slots, used to clear
+
+  std::vector<AstarNode*> OPEN;  // binary heap
+
+  static std::size_t getSlot(Key key, const std::size_t mask)
+  {
+    // mix bits, see splitmix64
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return (key ^ (key >> 31)) & mask;
+  }
+  bool isClosed(const Key key) const;
+  void close(const Key key);  // key must not be closed yet
+  void reset();
+
+public:
+  SpaceTimeAstar();
+  ~SpaceTimeAstar() {}
+
+  /*
+   * fValue(AstarNode*) -> int
+   * compare(AstarNode* a, AstarNode* b) -> true if b is expanded first
+   * checkAstarFin(AstarNode*) -> true at goal
+   * checkInvalidAstarNode(AstarNode*) -> true if violating constraints
+   * failed or time limit exceeded -> return {}
+   */
+  template <typename FValue, typename Compare, typename CheckFin,
+            typename CheckInvalid>
+  Path search(Node* const s, FValue&& fValue, Compare&& compare,
+              CheckFin&& checkAstarFin, CheckInvalid&& checkInvalidAstarNode,
+              const int time_limit = -1);
+};
+
+template <typename FValue, typename Compare, typename CheckFin,
+          typename CheckInvalid>
+Path SpaceTimeAstar::search(Node* const s, FValue&& fValue, Compare&& compare,
+                            CheckFin&& checkAstarFin,
+                            CheckInvalid&& checkInvalidAstarNode,
+                            const int time_limit)
+{
+  auto t_start = Time::now();
+  reset();
+
+  auto push = [&](AstarNode* n) {
+    OPEN.push_back(n);
+    std::push_heap(OPEN.begin(), OPEN.end(), compare);
+  };
+
+  // initial node
+  AstarNode* n = arena.peek();
+  *n = AstarNode{s, 0, 0, nullptr};
+  n->f = fValue(n);
+  arena.commit();
+  push(n);
+
+  // main loop
+  bool invalid = true;
+  while (!OPEN.empty()) {
+    // check time limit
+    if (time_limit > 0 && getElapsedTime(t_start) > time_limit) break;
+
+    // minimum node
+    std::pop_heap(OPEN.begin(), OPEN.end(), compare);
+    n = OPEN.back();
+    OPEN.pop_back();
+
+    // check CLOSE list
+    const Key key = getKey(n->v, n->g);
+    if (isClosed(key)) continue;
+    close(key);
+
+    // check goal condition
+    if (checkAstarFin(n)) {
+      invalid = false;
+      break;
+    }
+
+    // expand, neighbors then stay
+    const int g_cost = n->g + 1;
+    const int neighbors_size = n->v->neighbor.size();
+    for (int k = 0; k <= neighbors_size; ++k) {
+      Node* u = (k < neighbors_size) ? n->v->neighbor[k] : n->v;
+      // already searched?
+      if (isClosed(getKey(u, g_cost))) continue;
+      AstarNode* m = arena.peek();
+      *m = AstarNode{u, g_cost, 0, n};
+      // check constraints
+      if (checkInvalidAstarNode(m)) continue;
+      m->f = fValue(m);
+      arena.commit();
+      push(m);
+    }
+  }
+
+  Path path;
+  if (!invalid) {  // success
+    while (n != nullptr) {
+      path.push_back(n->v);
+      n = n->p;
+    }
+    std::reverse(path.begin(), path.end());
+  }
+  return path;
+}
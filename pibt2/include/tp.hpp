@@ -19,9 +19,11 @@ private:
   void updatePath2(int i, std::vector<Path>& TOKEN, Tasks& unassigned_tasks);
   void updatePath(int i, Node* g, std::vector<Path>& TOKEN);
 
-  std::vector<std::vector<int>> CONFLICT_TABLE;  // time, node -> agent
+  ReservationTable CONFLICT_TABLE;  // tokens, without staying forever
   static constexpr int NIL = -1;
 
+  bool use_sipp;  // low-level search, SIPP or space-time A*
+
   // main
   void run();
 
@@ -29,5 +31,6 @@ public:
   TP(MAPD_Instance* _P, bool _use_distance_table = false);
   ~TP() {}
 
+  void setParams(int argc, char* argv[]);
   static void printHelp();
 };
@@ -0,0 +1,78 @@
+/*
+ * compile-time tracing
+ *
+ * TRACE_LEVEL is given by cmake (-DTRACE_LEVEL=off|counters|events|full)
+ * - off:      nothing is emitted
+ * - counters: TRACE_COUNT statements are executed, e.g., PIBT::TraceCounters
+ * - events:   + TRACE_EVENT messages, e.g., swaps and cycles
+ * - full:     + TRACE_FULL messages, e.g., per-timestep details
+ * Counters needed by logs (e.g., PIBT::Metrics) are collected regardless.
+ *
+ * TRACE_ASSERT is independent of the level; it aborts with a message in
+ * debug builds and is compiled away when NDEBUG is defined.
+ * Arguments of disabled macros are never evaluated.
+ */
+
+#pragma once
+#include <cstdlib>
+#include <iostream>
+
+#define TRACE_LEVEL_OFF 0
+#define TRACE_LEVEL_COUNTERS 1
+#define TRACE_LEVEL_EVENTS 2
+#define TRACE_LEVEL_FULL 3
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL TRACE_LEVEL_OFF
+#endif
+
+namespace trace
+{
+template <typename... Args>
+void print(const char* tag, Args&&... args)
+{
+  std::cout << "[" << tag << "]";
+  ((std::cout << " " << args), ...);
+  std::cout << std::endl;
+}
+
+template <typename... Args>
+[[noreturn]] void fail(const char* cond, const char* file, const int line,
+                       Args&&... args)
+{
+  std::cout << "assertion failed: " << cond << " at " << file << ":" << line;
+  ((std::cout << " " << args), ...);
+  std::cout << std::endl;
+  std::abort();
+}
+}  // namespace trace
+
+#if TRACE_LEVEL >= TRACE_LEVEL_COUNTERS
+#define TRACE_COUNT(stmt) \
+  do {                    \
+    stmt;                 \
+  } while (0)
+#else
+#define TRACE_COUNT(stmt) ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_EVENTS
+#define TRACE_EVENT(...) trace::print("event", __VA_ARGS__)
+#else
+#define TRACE_EVENT(...) ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_FULL
+#define TRACE_FULL(...) trace::print("full", __VA_ARGS__)
+#else
+#define TRACE_FULL(...) ((void)0)
+#endif
+
+#ifndef NDEBUG
+#define TRACE_ASSERT(cond, ...)                                            \
+  do {                                                                     \
+    if (!(cond)) trace::fail(#cond, __FILE__, __LINE__, ##__VA_ARGS__);   \
+  } while (0)
+#else
+#define TRACE_ASSERT(cond, ...) ((void)0)
+#endif
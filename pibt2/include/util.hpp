@@ -4,16 +4,34 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <random>
+#include <thread>
+#include <vector>
 
 // for computation time
 using Time = std::chrono::steady_clock;
 
-// whether element 'a' is found in vector T
+// view of a contiguous array without ownership
 template <typename T>
-static bool inArray(const T a, const std::vector<T>& arr)
+struct Span {
+  T* ptr = nullptr;
+  int len = 0;
+
+  T* begin() const { return ptr; }
+  T* end() const { return ptr + len; }
+  int size() const { return len; }
+  bool empty() const { return len == 0; }
+  T& operator[](const int i) const { return ptr[i]; }
+};
+
+// whether element 'a' is found in arr, e.g., vector or Neighbors
+template <typename T, typename Array>
+static bool inArray(const T a, const Array& arr)
 {
   auto itr = std::find(arr.begin(), arr.end(), a);
   return itr != arr.end();
@@ -42,9 +60,27 @@ static bool inArray(const T a, const std::vector<T>& arr)
   return r(*MT);
 }
 
-// return one element randomly from vector
-template <typename T>
-static T randomChoose(const std::vector<T>& arr, std::mt19937* const MT)
+// xorshift32, a cheap generator for hot loops, the state must not be zero
+[[maybe_unused]] static std::uint32_t getRandomXorShift(std::uint32_t& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// splitmix64 finalizer, a bijection with good avalanche
+[[maybe_unused]] static std::uint64_t hashSplitMix64(std::uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// return one element randomly from arr, e.g., vector or Neighbors
+template <typename Array>
+static auto randomChoose(const Array& arr, std::mt19937* const MT)
 {
   return arr[getRandomInt(0, arr.size() - 1, MT)];
 }
@@ -56,3 +92,70 @@ static T randomChoose(const std::vector<T>& arr, std::mt19937* const MT)
   return std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start)
       .count();
 }
+
+
+// call func(k) for k = 0, ..., n-1 using a pool of num_threads workers
+// workers take the next index on demand, so uneven jobs are balanced
+template <typename F>
+static void parallelFor(const int n, const int num_threads, F&& func)
+{
+  const int workers = std::max(1, std::min(num_threads, n));
+  if (workers == 1) {
+    for (int k = 0; k < n; ++k) func(k);
+    return;
+  }
+  std::atomic<int> next(0);
+  std::vector<std::thread> pool;
+  for (int w = 0; w < workers; ++w) {
+    pool.emplace_back([&]() {
+      for (int k = next++; k < n; k = next++) func(k);
+    });
+  }
+  for (auto& th : pool) th.join();
+}
+
+// sort arr again, which was sorted by compare before its keys were updated
+// getRun(a) -> index in [0, runs_num) of a run whose relative order is kept
+// by the update, or -1 if the key of a changed arbitrarily
+// O(n * runs_num + r log r), where r is the number of elements with -1
+template <typename T, typename Compare, typename GetRun>
+static void resortRuns(std::vector<T>& arr, const int runs_num,
+                       Compare&& compare, GetRun&& getRun)
+{
+  std::vector<std::vector<T>> runs(runs_num + 1);
+  for (auto& a : arr) {
+    const int k = getRun(a);
+    runs[(k < 0) ? runs_num : k].push_back(a);
+  }
+  std::sort(runs[runs_num].begin(), runs[runs_num].end(), compare);
+
+  std::vector<T> tmp;
+  arr.clear();
+  for (auto& run : runs) {
+    if (run.empty()) continue;
+    tmp.clear();
+    std::merge(arr.begin(), arr.end(), run.begin(), run.end(),
+               std::back_inserter(tmp), compare);
+    std::swap(arr, tmp);
+  }
+}
+
+// sort five keys in ascending order by a sorting network of nine
+// compare-exchanges without branches, pad unused keys with UINT64_MAX
+[[maybe_unused]] static void sortFive(std::uint64_t* const keys)
+{
+  auto cmpExchange = [keys](const int i, const int j) {
+    const std::uint64_t a = keys[i], b = keys[j];
+    keys[i] = std::min(a, b);
+    keys[j] = std::max(a, b);
+  };
+  cmpExchange(0, 1);
+  cmpExchange(3, 4);
+  cmpExchange(2, 4);
+  cmpExchange(2, 3);
+  cmpExchange(0, 3);
+  cmpExchange(0, 2);
+  cmpExchange(1, 4);
+  cmpExchange(1, 3);
+  cmpExchange(1, 2);
+}
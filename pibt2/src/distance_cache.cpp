@@ -0,0 +1,164 @@
+#include "../include/distance_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+constexpr char DistanceCache::MAGIC[8];
+
+DistanceCache::DistanceCache(Graph* G, const int _stride,
+                             const std::string& dir)
+    : file(getFileName(G, _stride, dir)),
+      stride(_stride),
+      cells_size(0),
+      hash(getHash(G)),
+      data(nullptr),
+      data_size(0)
+{
+  for (int id = 0; id < G->getNodesSize(); ++id) {
+    if (G->getNode(id) != nullptr) ++cells_size;
+  }
+  open();
+}
+
+DistanceCache::~DistanceCache() { close(); }
+
+const DistanceCache::Dist* DistanceCache::find(Node* const g) const
+{
+  auto itr = rows.find(g->id);
+  return (itr == rows.end()) ? nullptr : itr->second;
+}
+
+void DistanceCache::open()
+{
+  if (file.empty()) return;
+  const int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) return;  // not created yet
+  struct stat st;
+  if (fstat(fd, &st) == 0 && (std::size_t)st.st_size >= sizeof(Header)) {
+    data_size = st.st_size;
+    data = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) data = nullptr;
+  }
+  ::close(fd);
+  if (data == nullptr) {
+    warn("failed to read " + file);
+    return;
+  }
+
+  // validate
+  const auto header = static_cast<const Header*>(data);
+  const std::size_t expected =
+      sizeof(Header) + header->rows_size * sizeof(std::int32_t) +
+      header->rows_size * getRowSize() * sizeof(Dist);
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header->version != VERSION || header->stride != (std::uint32_t)stride ||
+      header->hash != hash || header->cells_size != (std::uint32_t)cells_size ||
+      data_size != expected) {
+    warn("ignore stale cache " + file);
+    close();
+    return;
+  }
+
+  auto goals = reinterpret_cast<const std::int32_t*>(header + 1);
+  auto table = reinterpret_cast<const Dist*>(goals + header->rows_size);
+  for (std::uint32_t k = 0; k < header->rows_size; ++k) {
+    rows[goals[k]] = table + k * getRowSize();
+  }
+}
+
+void DistanceCache::close()
+{
+  if (data != nullptr) munmap(data, data_size);
+  data = nullptr;
+  data_size = 0;
+  rows.clear();
+}
+
+void DistanceCache::store(
+    const std::vector<std::pair<int, const Dist*>>& new_rows)
+{
+  if (file.empty()) return;
+
+  std::vector<std::pair<int, const Dist*>> all_rows(rows.begin(), rows.end());
+  for (auto& row : new_rows) {
+    if (rows.find(row.first) == rows.end()) all_rows.push_back(row);
+  }
+
+  Header header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.stride = stride;
+  header.hash = hash;
+  header.cells_size = cells_size;
+  header.rows_size = all_rows.size();
+
+  // write to a temporal file, then replace, concurrent readers are safe
+  const std::string tmp_file = file + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmp_file, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  for (auto& row : all_rows) {
+    const std::int32_t id = row.first;
+    out.write(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+  for (auto& row : all_rows) {
+    out.write(reinterpret_cast<const char*>(row.second),
+              getRowSize() * sizeof(Dist));
+  }
+  out.close();
+  if (!out || std::rename(tmp_file.c_str(), file.c_str()) != 0) {
+    std::remove(tmp_file.c_str());
+    warn("failed to write " + file);
+  }
+}
+
+void DistanceCache::warn(const std::string& msg) const
+{
+  std::cout << "warn@DistanceCache: " << msg << std::endl;
+}
+
+// FNV-1a over the graph structure
+std::uint64_t DistanceCache::getHash(Graph* G)
+{
+  std::uint64_t h = 14695981039346656037ULL;
+  auto add = [&](const std::int64_t x) {
+    for (int k = 0; k < 8; ++k) {
+      h ^= (x >> (8 * k)) & 0xff;
+      h *= 1099511628211ULL;
+    }
+  };
+  add(G->getNodesSize());
+  for (int id = 0; id < G->getNodesSize(); ++id) {
+    Node* v = G->getNode(id);
+    if (v == nullptr) continue;
+    add(v->id);
+    add(v->pos.x);
+    add(v->pos.y);
+    for (auto u : v->neighbor) add(u->id);
+  }
+  return h;
+}
+
+std::string DistanceCache::getFileName(Graph* G, const int stride,
+                                       const std::string& dir)
+{
+  auto grid = dynamic_cast<Grid*>(G);
+  if (grid == nullptr) return "";
+  const std::string suffix = ".dist" + std::to_string(stride);
+  if (!dir.empty()) {
+    const auto& map_file = grid->getMapFileName();
+    const auto name = map_file.substr(map_file.find_last_of('/') + 1);
+    return dir + "/" + name + suffix;
+  }
+#ifdef _MAPDIR_
+  return _MAPDIR_ + grid->getMapFileName() + suffix;
+#else
+  return grid->getMapFileName() + suffix;
+#endif
+}
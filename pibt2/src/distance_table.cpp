@@ -0,0 +1,238 @@
+#include "../include/distance_table.hpp"
+
+#include <limits>
+
+#include "../include/util.hpp"
+
+DistanceTable::DistanceTable(Graph* _G, const int _max_dist,
+                             const bool with_orientation)
+    : G(_G),
+      max_dist(std::min(_max_dist, (int)std::numeric_limits<Dist>::max())),
+      stride(with_orientation ? ORIENTATIONS : 1),
+      cell_index(G->getNodesSize(), NIL),
+      lazy(false),
+      max_slots(0),
+      clock(0),
+      evicted_cnt(0)
+{
+  for (int id = 0; id < G->getNodesSize(); ++id) {
+    Node* v = G->getNode(id);
+    if (v == nullptr) continue;
+    cell_index[id] = cells.size();
+    cells.push_back(v);
+  }
+  row_of_goal.resize(cells.size(), NIL);
+}
+
+int DistanceTable::addGoal(Node* const g)
+{
+  const int c = cell_index[g->id];
+  if (row_of_goal[c] == NIL) {
+    row_of_goal[c] = goals.size();
+    goals.push_back(g);
+  }
+  return row_of_goal[c];
+}
+
+int DistanceTable::getRow(Node* const g) const
+{
+  return row_of_goal[cell_index[g->id]];
+}
+
+void DistanceTable::build(const int num_threads, DistanceCache* cache)
+{
+  table.resize(getRowOffset(goals.size()));
+  const std::size_t row_size = getRowOffset(1);
+
+  // load cached rows
+  std::vector<int> rows;  // to compute
+  for (int row = 0; row < (int)goals.size(); ++row) {
+    auto d = (cache != nullptr) ? cache->find(goals[row]) : nullptr;
+    if (d == nullptr) {
+      rows.push_back(row);
+      continue;
+    }
+    std::transform(d, d + row_size, &table[getRowOffset(row)],
+                   [&](const Dist x) { return std::min(x, max_dist); });
+  }
+
+  // rows are independent of each other,
+  // cached rows are not capped to be reused with other max_timestep
+  const Dist limit = (cache != nullptr) ? DistanceCache::UNREACHABLE : max_dist;
+  parallelFor(rows.size(), num_threads,
+              [&](int k) { createRow(rows[k], limit); });
+  if (cache != nullptr && !rows.empty()) {
+    std::vector<std::pair<int, const Dist*>> new_rows;
+    for (auto row : rows) {
+      new_rows.push_back({goals[row]->id, &table[getRowOffset(row)]});
+    }
+    cache->store(new_rows);
+    for (auto row : rows) {
+      Dist* d = &table[getRowOffset(row)];
+      std::transform(d, d + row_size, d,
+                     [&](const Dist x) { return std::min(x, max_dist); });
+    }
+  }
+
+  // orientation-free view
+  if (stride == 1) return;
+  collapsed.resize(goals.size() * cells.size());
+  parallelFor(goals.size(), num_threads, [&](int row) { collapseRow(row); });
+}
+
+void DistanceTable::collapseRow(const int row)
+{
+  const Dist* d = &table[getRowOffset(row)];
+  Dist* d_min = &collapsed[(std::size_t)row * cells.size()];
+  const int cells_size = cells.size();
+  for (int c = 0; c < cells_size; ++c, d += stride) {
+    d_min[c] = *std::min_element(d, d + stride);
+  }
+}
+
+void DistanceTable::setLazy(const std::size_t memory_budget)
+{
+  lazy = true;
+  const std::size_t row_size = getRowOffset(1);
+  const std::size_t row_memory = row_size * (sizeof(Dist) + sizeof(int));
+  max_slots = goals.size();
+  if (memory_budget > 0) {
+    max_slots = std::min(max_slots, (int)(memory_budget / row_memory));
+    max_slots = std::max(max_slots, 1);
+  }
+  slots.clear();
+  slot_of_row.assign(goals.size(), NIL);
+  table.clear();
+  collapsed.clear();
+  table.reserve(max_slots * row_size);
+}
+
+std::size_t DistanceTable::getMemoryUsage() const
+{
+  std::size_t usage = (table.size() + collapsed.size()) * sizeof(Dist);
+  for (auto& slot : slots) usage += slot.OPEN.size() * sizeof(int);
+  return usage;
+}
+
+void DistanceTable::createRow(const int row, const Dist limit)
+{
+  Dist* dist = &table[getRowOffset(row)];
+  std::vector<int> OPEN(cells.size() * stride);
+  int head = 0, tail = 0;
+  initRow(goals[row], dist, OPEN.data(), tail, limit);
+  while (head < tail) expand(dist, OPEN.data(), head, tail, limit);
+}
+
+void DistanceTable::initRow(Node* const g, Dist* dist, int* OPEN, int& tail,
+                            const Dist limit) const
+{
+  std::fill(dist, dist + getRowOffset(1), limit);
+  const int c_g = cell_index[g->id];
+  if (stride == 1) {
+    dist[c_g] = 0;
+    OPEN[tail++] = c_g;
+    return;
+  }
+  for (Orientation goal_dir : {Orientation::X_PLUS, Orientation::X_MINUS,
+                               Orientation::Y_PLUS, Orientation::Y_MINUS}) {
+    const int s = getStateIndex(c_g, goal_dir);
+    dist[s] = 0;
+    OPEN[tail++] = s;
+  }
+}
+
+// pop one state and relax its predecessors
+void DistanceTable::expand(Dist* dist, int* OPEN, int& head, int& tail,
+                           const Dist limit) const
+{
+  const int s = OPEN[head++];
+  const int d_next = dist[s] + 1;
+  if (d_next >= limit) return;
+
+  // without orientation
+  if (stride == 1) {
+    for (auto u : cells[s]->neighbor) {
+      const int s_next = cell_index[u->id];
+      if (d_next < dist[s_next]) {
+        dist[s_next] = d_next;
+        OPEN[tail++] = s_next;
+      }
+    }
+    return;
+  }
+
+  const int c = s / ORIENTATIONS;
+  const auto dir = static_cast<Orientation>(s % ORIENTATIONS);
+
+  // rotate by 90 degrees
+  for (auto new_dir : {rotateClockwise(dir), rotateCounterClockwise(dir)}) {
+    const int s_next = getStateIndex(c, new_dir);
+    if (d_next < dist[s_next]) {
+      dist[s_next] = d_next;
+      OPEN[tail++] = s_next;
+    }
+  }
+
+  // move forward, from the neighbor behind heading to the cell
+  Node* u = getAdjacent(cells[c], getOpposite(dir));
+  if (u == nullptr) return;
+  const int s_next = getStateIndex(cell_index[u->id], dir);
+  if (d_next < dist[s_next]) {
+    dist[s_next] = d_next;
+    OPEN[tail++] = s_next;
+  }
+}
+
+int DistanceTable::getLazy(const int row, const int state) const
+{
+  int k = slot_of_row[row];
+  if (k == NIL) k = assignSlot(row);
+  Slot& slot = slots[k];
+  slot.last_used = ++clock;
+
+  // in BFS, the first assigned distance is final
+  Dist* dist = &table[getRowOffset(k)];
+  while (dist[state] == max_dist && slot.head < slot.tail) {
+    expand(dist, slot.OPEN.data(), slot.head, slot.tail, max_dist);
+  }
+  return dist[state];
+}
+
+int DistanceTable::getLazyAnyDir(const int row, const int cell) const
+{
+  int d = max_dist;
+  for (int k = 0; k < stride; ++k) {
+    d = std::min(d, getLazy(row, cell * stride + k));
+  }
+  return d;
+}
+
+int DistanceTable::assignSlot(const int row) const
+{
+  int k;
+  if ((int)slots.size() < max_slots) {
+    // new slot
+    k = slots.size();
+    slots.push_back(
+        Slot{NIL, 0, std::vector<int>(cells.size() * stride), 0, 0});
+    table.resize(getRowOffset(k + 1));
+  } else {
+    // evict the least recently used row
+    k = std::min_element(slots.begin(), slots.end(),
+                         [](const Slot& a, const Slot& b) {
+                           return a.last_used < b.last_used;
+                         }) -
+        slots.begin();
+    slot_of_row[slots[k].row] = NIL;
+    ++evicted_cnt;
+  }
+
+  Slot& slot = slots[k];
+  slot.row = row;
+  slot.head = 0;
+  slot.tail = 0;
+  slot_of_row[row] = k;
+  initRow(goals[row], &table[getRowOffset(k)], slot.OPEN.data(), slot.tail,
+          max_dist);
+  return k;
+}
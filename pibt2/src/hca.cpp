@@ -15,9 +15,11 @@ void HCA::run()
   Paths paths(P->getNum());
 
   // create tables for tie-break
+  table_starts.clear();
+  table_goals.clear();
   for (int i = 0; i < P->getNum(); ++i) {
-    table_starts[P->getStart(i)->id] = true;
-    table_goals[P->getGoal(i)->id] = true;
+    table_starts.set(P->getStart(i)->id, true);
+    table_goals.set(P->getGoal(i)->id, true);
   }
 
   // prioritization, far agent is prioritized
@@ -94,15 +96,19 @@ void HCA::setParams(int argc, char* argv[])
 {
   struct option longopts[] = {
       {"disable-dist-init", no_argument, 0, 'd'},
+      {"sipp", no_argument, 0, 'S'},
       {0, 0, 0, 0},
   };
   optind = 1;  // reset
   int opt, longindex;
-  while ((opt = getopt_long(argc, argv, "d", longopts, &longindex)) != -1) {
+  while ((opt = getopt_long(argc, argv, "dS", longopts, &longindex)) != -1) {
     switch (opt) {
       case 'd':
         disable_dist_init = true;
         break;
+      case 'S':
+        use_sipp = true;
+        break;
       default:
         break;
     }
@@ -115,5 +121,9 @@ void HCA::printHelp()
             << "  -d --disable-dist-init"
             << "        "
             << "disable initialization of priorities "
-            << "using distance from starts to goals" << std::endl;
+            << "using distance from starts to goals"
+            << "\n  -S --sipp"
+            << "                    "
+            << "use SIPP instead of space-time A* as low-level search"
+            << std::endl;
 }
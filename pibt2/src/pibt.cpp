@@ -1,36 +1,18 @@
 #include "../include/pibt.hpp"
 
-// for debug
-#define SAFE_VALUE(opt, agent_id) \
-    ([&]() -> decltype(auto) { \
-        if (!(opt).has_value()) { \
-            std::cerr << "FATAL: Agent " << (agent_id) \
-                      << " has no orientation at " << __FILE__ \
-                      << ":" << __LINE__ << std::endl; \
-            std::abort(); \
-        } \
-        return (opt).value(); \
-    })()
-
-
-std::string orientationToString(Orientation dir) {
-    switch (dir) {
-        case Orientation::X_PLUS:  return "X_PLUS";
-        case Orientation::X_MINUS: return "X_MINUS";
-        case Orientation::Y_PLUS:  return "Y_PLUS";
-        case Orientation::Y_MINUS: return "Y_MINUS";
-        default: return "UNKNOWN";
-    }
-}
+#include "../include/trace.hpp"
+
+#include <fstream>
 
 const std::string PIBT::SOLVER_NAME = "PIBT";
 
 PIBT::PIBT(MAPF_Instance* _P)
     : MAPF_Solver(_P), 
-      occupied_now(Agents(G->getNodesSize(), nullptr)),
-      occupied_next(Agents(G->getNodesSize(), nullptr)),
+      occupied_now(G->getNodesSize(), NIL),
+      occupied_next(G->getNodesSize(), NIL),
       reserved_nodes(P->getNum(), nullptr),  
-      push_count_table(P->getNum(), std::vector<int>(P->getNum(), 0))
+      push_history(P->getNum() * PUSH_HISTORY_SIZE, PushRecord{NIL, 0}),
+      push_history_head(P->getNum(), 0)
 {
   solver_name = PIBT::SOLVER_NAME;
 }
@@ -38,38 +20,63 @@ PIBT::PIBT(MAPF_Instance* _P)
 
 void PIBT::run()
 {
-  
-  std::cout << "=== Starting PIBT::run() ===" << std::endl;
+  TRACE_EVENT("start PIBT, agents:", P->getNum());
   // compare priority of agents
-  auto compare = [](Agent* a, const Agent* b) {
-    if (a->elapsed != b->elapsed) return a->elapsed > b->elapsed;
+  auto compare = [&](const int a, const int b) {
+    if (A.elapsed[a] != A.elapsed[b]) return A.elapsed[a] > A.elapsed[b];
     // use initial distance
-    if (a->init_d != b->init_d) return a->init_d > b->init_d;
-    return a->tie_breaker > b->tie_breaker;
+    if (A.init_d[a] != A.init_d[b]) return A.init_d[a] > A.init_d[b];
+    return A.tie_breaker[a] > A.tie_breaker[b];
   };
-  Agents A;
 
   // initialize
-  for (int i = 0; i < P->getNum(); ++i) {
-    Node* s = P->getStart(i);
-    Node* g = P->getGoal(i);
-    int d = disable_dist_init ? 0 : pathDist(i,s,Orientation::Y_MINUS);
-    Agent* a = new Agent{i,                          // id
-                         s,                          // current location
-                         nullptr,                    // next location
-                         g,                          // goal
-                         Orientation::Y_MINUS,        // current orientation
-                         std::nullopt,               // next orientation
-                         0,                          // elapsed
-                         d,                          // dist from s -> g
-                         getRandomFloat(0, 1, MT)};  // tie-breaker
-    a->swap_completed = true;
-    A.push_back(a);
-    occupied_now[s->id] = a;
+  const int N = P->getNum();
+  A.v_now = P->getConfigStart();
+  A.v_next.assign(N, nullptr);
+  A.g = P->getConfigGoal();
+  A.ott_now.assign(N, Orientation::Y_MINUS);
+  A.ott_next.assign(N, Orientation::Y_MINUS);
+  A.elapsed.assign(N, 0);
+  A.init_d.assign(N, 0);
+  trace_counters = TraceCounters();
+  A.tie_breaker.assign(N, 0);
+  A.rng.assign(N, 1);
+  A.swap_completed.assign(N, true);
+  order.resize(N);
+  for (int i = 0; i < N; ++i) {
+    // dist from s -> g
+    if (!disable_dist_init) {
+      A.init_d[i] = pathDist(i, A.v_now[i], Orientation::Y_MINUS);
+    }
+    A.tie_breaker[i] = getRandomFloat(0, 1, MT);
+    A.rng[i] = (*MT)() | 1;  // non-zero
+    order[i] = i;
+    occupied_now.set(A.v_now[i]->id, i);
+  }
+  solution.addWithOrientation(A.v_now, A.ott_now);
+  appendLog();
+
+  // hash of the current configuration, updated by moved agents
+  std::uint64_t config_hash = 0;
+  livelock_period = 0;
+  if (livelock_window > 0) {
+    for (int i = 0; i < N; ++i) {
+      config_hash ^= getStateHash(i, A.v_now[i], A.ott_now[i]);
+    }
+    config_hash_hist.assign(livelock_window, 0);
+    period_hist.assign(livelock_window, 0);
+    livelock_repeats = 0;
+    detectLivelock(config_hash, 0);
   }
-  Config initial_config = P->getConfigStart();
-  std::vector<Orientation> initial_orients(P->getNum(), Orientation::Y_MINUS);
-  solution.addWithOrientation(initial_config, initial_orients);
+
+  // elapsed of each agent when the priorities were sorted last time
+  std::vector<int> elapsed_sorted(N, 0);
+  auto getRun = [&](const int i) {
+    const int e = elapsed_sorted[i];
+    if (A.elapsed[i] == e + 1) return 0;        // incremented
+    if (A.elapsed[i] == 0 && e == 0) return 1;  // stay at goal
+    return -1;                                  // reached goal
+  };
 
   // main loop
   int timestep = 0;
@@ -77,50 +84,62 @@ void PIBT::run()
   while (true) {
   //while (timestep < max_loop) {
     info(" ", "elapsed:", getSolverElapsedTime(), ", timestep:", timestep);
+    const auto t_plan = Time::now();
+    metrics = Metrics{0, 0, 0, 0, 0, 0, 0, 0};
 
-    for (size_t i = 0; i < occupied_next.size(); ++i) {
-            if (occupied_next[i] != nullptr) {
-                std::cout << "Warning: occupied_next[" << i 
-                << "] not cleared from previous timestep" << std::endl;}}
-
-    // planning
-    std::sort(A.begin(), A.end(), compare);
-    for (auto a : A) {
+    // planning, priorities are sorted incrementally after the first step
+    if (timestep == 0) {
+      std::sort(order.begin(), order.end(), compare);
+    } else {
+      resortRuns(order, 2, compare, getRun);
+    }
+    for (auto i : order) {
+      elapsed_sorted[i] = A.elapsed[i];
       // if the agent has next location, then skip
-      if (a->v_next == nullptr) {
+      if (A.v_next[i] == nullptr) {
         // determine its next location
-        funcPIBT(a);
+        funcPIBT(i);
       }
     }
 
-    // plan.cpp
-    bool check_goal_cond = true;
-    Config config(P->getNum(), nullptr); //plan.cpp
-    std::vector<Orientation> orients(P->getNum());
-
-    for (auto a : A) {
-      if (occupied_now[a->v_now->id] == a) occupied_now[a->v_now->id] = nullptr;
-      occupied_next[a->v_next->id] = nullptr;
-      
-      // set next location and orientation
-      config[a->id] = a->v_next;
-      orients[a->id] = SAFE_VALUE(a->ott_next, a->id); 
-      occupied_now[a->v_next->id] = a;
+    // update occupancy, the result does not depend on the order of agents
+    occupied_now.clear();
+    occupied_next.clear();
+    for (int i = 0; i < N; ++i) {
+      TRACE_ASSERT(A.v_next[i] != nullptr, "agent", i, "has no next location");
+      occupied_now.set(A.v_next[i]->id, i);
+    }
 
+    // commit actions
+    bool check_goal_cond = true;
+    for (int i = 0; i < N; ++i) {
+      if (A.v_next[i] != A.v_now[i]) {
+        ++metrics.forward_moves;
+      } else if (A.ott_next[i] != A.ott_now[i]) {
+        ++metrics.rotations;
+      }
+      if (livelock_window > 0 && (A.v_next[i] != A.v_now[i] ||
+                                  A.ott_next[i] != A.ott_now[i])) {
+        config_hash ^= getStateHash(i, A.v_now[i], A.ott_now[i]) ^
+                       getStateHash(i, A.v_next[i], A.ott_next[i]);
+      }
+      const bool at_goal = (A.v_next[i] == A.g[i]);
       // check goal condition
-      check_goal_cond &= (a->v_next == a->g);
+      check_goal_cond &= at_goal;
       // update priority
-      a->elapsed = (a->v_next == a->g) ? 0 : a->elapsed + 1;
-      // reset params
-      a->v_now = a->v_next;
-      a->v_next = nullptr;
-
-      a->ott_now = a->ott_next;
-      a->ott_next = std::nullopt;
+      A.elapsed[i] = at_goal ? 0 : A.elapsed[i] + 1;
     }
+    std::swap(A.v_now, A.v_next);
+    std::swap(A.ott_now, A.ott_next);
+    std::fill(A.v_next.begin(), A.v_next.end(), nullptr);
 
     // update plan
-    solution.addWithOrientation(config, orients);
+    solution.addWithOrientation(A.v_now, A.ott_now);
+    appendLog();
+    metrics.latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             Time::now() - t_plan)
+                             .count();
+    metrics_hist.push_back(metrics);
 
     ++timestep;
 
@@ -130,95 +149,119 @@ void PIBT::run()
       break;
     }
 
+    // livelock
+    if (livelock_window > 0 && detectLivelock(config_hash, timestep)) {
+      info(" ", "livelock detected at timestep", timestep, ", period:",
+           livelock_period);
+      TRACE_EVENT("livelock, timestep:", timestep, "period:", livelock_period);
+      break;
+    }
+
     // failed
     if (timestep >= max_timestep || overCompTime()) {
       break;
     }
   }
 
-  // memory clear
-  for (auto a : A) {
-    if (a) {
-        delete a;
+  TRACE_COUNT(trace::print(
+      "counters", "request pushes:", trace_counters.request_pushes,
+      "pops:", trace_counters.request_pops,
+      "max chain:", trace_counters.max_request_chain,
+      "cycle checks:", trace_counters.cycle_checks,
+      "blocked candidates:", trace_counters.blocked_candidates,
+      "push escape checks:", trace_counters.push_escape_checks));
+}
+
+std::uint64_t PIBT::getStateHash(const int i, Node* const v,
+                                 const Orientation o) const
+{
+  const std::uint64_t k =
+      (std::uint64_t(i) * G->getNodesSize() + v->id) * 4 + toIndex(o);
+  return hashSplitMix64(k);
+}
+
+bool PIBT::detectLivelock(const std::uint64_t config_hash, const int timestep)
+{
+  // latest timestep with the same configuration within the window
+  int period = 0;
+  for (int l = 1; l <= std::min(livelock_window, timestep); ++l) {
+    if (config_hash_hist[(timestep - l) % livelock_window] == config_hash) {
+      period = l;
+      break;
     }
   }
-  A.clear();
+  const int k = timestep % livelock_window;
+  livelock_repeats += (period > 0) - (period_hist[k] > 0);
+  config_hash_hist[k] = config_hash;
+  period_hist[k] = period;
+  if (timestep < livelock_window || 2 * livelock_repeats < livelock_window) {
+    return false;
+  }
+
+  // report the most frequent period in the window
+  std::vector<int> cnts(livelock_window + 1, 0);
+  for (auto l : period_hist) ++cnts[l];
+  cnts[0] = 0;
+  livelock_period =
+      std::max_element(cnts.begin(), cnts.end()) - cnts.begin();
+  return true;
 }
 
-bool PIBT::funcPIBT(Agent* ai, Agent* aj, bool is_initial)
+bool PIBT::funcPIBT(const int ai, const int aj, bool is_initial)
 {
+  ++metrics.funcpibt_calls;
+  metrics.max_depth = std::max(metrics.max_depth, depth);
+
   if (is_initial) {
         request_chain.clear();
         cycle_handled = false;
         initial_requester = ai;
     }
 
-  // compare two nodes by LGS
-  auto compare = [&](Node* const v, Node* const u) {   
-    float d_v;
-    if (v == ai->v_now) {
-        d_v = getMinDistToGoal(ai->id, v, SAFE_VALUE(ai->ott_now, ai->id)) + 1;
+  // get candidates by LGS, each is scored once and sorted by the key
+  // [distance with rotation cost | occupied | random tie-break | index]
+  Node* const v_now = A.v_now[ai];
+  const int K = v_now->neighbor.size() + 1;  // neighbors and staying
+  TRACE_ASSERT(K <= MAX_CANDIDATES, "too many candidates of agent", ai);
+  Node* candidates[MAX_CANDIDATES];
+  std::uint64_t keys[MAX_CANDIDATES];
+  std::fill(keys, keys + MAX_CANDIDATES, UINT64_MAX);
+  for (int k = 0; k < K; ++k) {
+    Node* const u = (k < K - 1) ? v_now->neighbor[k] : v_now;
+    candidates[k] = u;
+    int d;
+    if (u == v_now) {
+      d = getMinDistToGoal(ai, u, A.ott_now[ai]) + 1;
     } else {
-        Orientation target_dir_v = solution.getRelativePosition(ai->v_now, v);
-        d_v = getMinDistToGoal(ai->id, v, target_dir_v);
-    }
-
-    float d_u;
-    if (u == ai->v_now) {
-        d_u = getMinDistToGoal(ai->id, u, SAFE_VALUE(ai->ott_now, ai->id)) + 1;
-    } else {
-        Orientation target_dir_u = solution.getRelativePosition(ai->v_now, u);
-        d_u = getMinDistToGoal(ai->id, u, target_dir_u);
-    }
-    
-    if (v != ai->v_now) {
-        Orientation target_dir_v = solution.getRelativePosition(ai->v_now, v);
-        int angle_diff_v = solution.getAngleDifference(SAFE_VALUE(ai->ott_now, ai->id), target_dir_v);
-        if (angle_diff_v == 0) d_v += 1;
-        else if (angle_diff_v == 90) d_v += 2;
-        else if (angle_diff_v == 180) d_v += 3;
-    }
-    
-    if (u != ai->v_now) {
-        Orientation target_dir_u = solution.getRelativePosition(ai->v_now, u);
-        int angle_diff_u = solution.getAngleDifference(SAFE_VALUE(ai->ott_now, ai->id), target_dir_u);
-        if (angle_diff_u == 0) d_u += 1;
-        else if (angle_diff_u == 90) d_u += 2;
-        else if (angle_diff_u == 180) d_u += 3;
-    }
-
-    if (d_v != d_u) return d_v < d_u;
-
-    // tie break
-    if (occupied_now[v->id] != nullptr && occupied_now[u->id] == nullptr)
-      return false;
-    if (occupied_now[v->id] == nullptr && occupied_now[u->id] != nullptr)
-      return true;
-    return false;
-  };
+      // 1, 2 or 3 steps to move forward
+      const Orientation dir = solution.getRelativePosition(v_now, u);
+      d = getMinDistToGoal(ai, u, dir) +
+          solution.getAngleDifference(A.ott_now[ai], dir) / 90 + 1;
+    }
+    const std::uint64_t score = 2 * d + (occupied_now[u->id] != NIL);
+    const std::uint64_t tie = getRandomXorShift(A.rng[ai]);
+    keys[k] = (score << 35) | (tie << 3) | k;
+  }
+  sortFive(keys);
+  Nodes C(K);
+  for (int k = 0; k < K; ++k) C[k] = candidates[keys[k] & 7];
 
-  // get candidates by LGS
-  Nodes C = ai->v_now->neighbor;
-  C.push_back(ai->v_now);
-  // randomize
-  std::shuffle(C.begin(), C.end(), *MT);
-  // sort
-  std::sort(C.begin(), C.end(), compare);
-  
-  if (!is_initial && aj != nullptr) {
-    PushEscapeTrigger(C, ai->id, aj->id);
+  if (!is_initial && aj != NIL) {
+    TRACE_COUNT(++trace_counters.push_escape_checks);
+    PushEscapeTrigger(C, ai, aj);
   }
   
-  Agent* swap_agent = swap_possible_and_required(ai, C);
-  if (swap_agent != nullptr){
+  const int swap_agent = swap_possible_and_required(ai, C);
+  if (swap_agent != NIL){
     std::reverse(C.begin(), C.end());
-    std::cout << "Swap agent :" << swap_agent->id << std::endl;    
-    }
+    ++metrics.swaps;
+    TRACE_EVENT("swap, agent:", ai, "swap agent:", swap_agent);
+  }
   
   int m = 0;
 
-  if (reserved_nodes[ai->id] != nullptr) {
-    auto reserved_node = std::find(C.begin(), C.end(), reserved_nodes[ai->id]);
+  if (reserved_nodes[ai] != nullptr) {
+    auto reserved_node = std::find(C.begin(), C.end(), reserved_nodes[ai]);
     if (reserved_node != C.end()) {
         Node* reserved = *reserved_node;
         C.erase(reserved_node);
@@ -229,45 +272,56 @@ bool PIBT::funcPIBT(Agent* ai, Agent* aj, bool is_initial)
 
   for (auto u : C) {
     // avoid conflicts
-    if (occupied_next[u->id] != nullptr) {
+    if (occupied_next[u->id] != NIL) {
                   m++;
+                  TRACE_COUNT(++trace_counters.blocked_candidates);
                   continue;
     }
-    if (aj != nullptr && u == aj->v_now) {
+    if (aj != NIL && u == A.v_now[aj]) {
         m++;
+        TRACE_COUNT(++trace_counters.blocked_candidates);
         continue;
     }
 
     // reserve
-    occupied_next[u->id] = ai;
-    ai->v_next = u;
+    occupied_next.set(u->id, ai);
+    A.v_next[ai] = u;
 
     // check if cycle occurs
-    if (!is_initial && u == initial_requester->v_now) {
-        std::cout << "Cycle detected: Agent " << ai->id 
-                    << " requests node occupied by initial requester " 
-                    << initial_requester->id << std::endl;
-
-    // [Debug] available orientation or not
-        if (!ai->ott_now.has_value()) {
-            std::cerr << "Error: Agent " << ai->id << " has no valid orientation during cycle detection" << std::endl;
-            exit(1);
-        }
+    TRACE_COUNT(if (!is_initial) ++trace_counters.cycle_checks);
+    if (!is_initial && u == A.v_now[initial_requester]) {
+        TRACE_EVENT("cycle, agent:", ai,
+                    "initial requester:", initial_requester,
+                    "chain size:", request_chain.size() + 1);
 
         request_chain.push_back({ai, u});
+        TRACE_COUNT(++trace_counters.request_pushes;
+                    trace_counters.max_request_chain =
+                        std::max(trace_counters.max_request_chain,
+                                 (int)request_chain.size()));
         handleCycleWithOrientation();
+        ++metrics.cycles;
         cycle_handled = true;
         return true;
     }
 
     auto ak = occupied_now[u->id];
-    if (ak != nullptr && ak->v_next == nullptr) {
+    if (ak != NIL && A.v_next[ak] == nullptr) {
       request_chain.push_back({ai, u});
-      if (!funcPIBT(ak, ai, false)) {
+      TRACE_COUNT(++trace_counters.request_pushes;
+                  trace_counters.max_request_chain =
+                      std::max(trace_counters.max_request_chain,
+                               (int)request_chain.size()));
+      ++depth;
+      const bool valid = funcPIBT(ak, ai, false);
+      --depth;
+      if (!valid) {
         request_chain.pop_back();
-        occupied_next[u->id] = nullptr;
-        ai->v_next = nullptr;
+        occupied_next.set(u->id, NIL);
+        A.v_next[ai] = nullptr;
         m++;
+        TRACE_COUNT(++trace_counters.request_pops;
+                    ++trace_counters.blocked_candidates);
         continue;
       }  // replanning
 
@@ -280,87 +334,87 @@ bool PIBT::funcPIBT(Agent* ai, Agent* aj, bool is_initial)
 
     // compute the first to move to next vertex u
     auto [next_node, next_orientation] = solution.computeAction(
-        ai->v_now,    
+        A.v_now[ai],    
         u,           
-        SAFE_VALUE(ai->ott_now, ai->id)  
+        A.ott_now[ai]  
     );
         
     // if agent cannot move to a new vertex, change its orientation
-    if (next_node == ai->v_now) {
+    if (next_node == A.v_now[ai]) {
         // reset the vertex occupied and change orientation when needed
-        ai->v_next = ai->v_now;
-        occupied_next[u->id] = nullptr;
-        occupied_next[ai->v_next->id] = ai;
-        ai->ott_next = next_orientation;
-        if(ai->swap_completed){reserved_nodes[ai->id] = nullptr;} // reserve the node before swap is completed
-        if (next_orientation != ai->ott_now){
-            reserved_nodes[ai->id] = u;    
+        A.v_next[ai] = A.v_now[ai];
+        occupied_next.set(u->id, NIL);
+        occupied_next.set(A.v_next[ai]->id, ai);
+        A.ott_next[ai] = next_orientation;
+        if(A.swap_completed[ai]){reserved_nodes[ai] = nullptr;} // reserve the node before swap is completed
+        if (next_orientation != A.ott_now[ai]){
+            reserved_nodes[ai] = u;    
         }
     }
     else {
         // if agent can moving forward then do so
-        ai->v_next = next_node;
-        ai->ott_next = next_orientation;
-        occupied_next[ai->v_next->id] = ai;
-        reserved_nodes[ai->id] = nullptr;
+        A.v_next[ai] = next_node;
+        A.ott_next[ai] = next_orientation;
+        occupied_next.set(A.v_next[ai]->id, ai);
+        reserved_nodes[ai] = nullptr;
 
-        if (!is_initial && aj != nullptr && ai->v_next != ai->v_now) {
-            updatePushCount(ai->id, aj->id);
+        if (!is_initial && aj != NIL && A.v_next[ai] != A.v_now[ai]) {
+            updatePushCount(ai, aj);
         }
         
         
     }
 
     auto al = occupied_now[u->id];
-    if (al != nullptr && al->v_next == al->v_now) {
+    if (al != NIL && A.v_next[al] == A.v_now[al]) {
         // other agent must stay because it will adjust orientation, current agent must also stay
-        if(next_node!=ai->v_now){ //if current agent wants to moving forward
-        occupied_next[ai->v_now->id] = ai;
-        ai->v_next = ai->v_now; // reserve current vertex
-        ai->ott_next = ai->ott_now; 
+        if(next_node!=A.v_now[ai]){ //if current agent wants to moving forward
+        occupied_next.set(A.v_now[ai]->id, ai);
+        A.v_next[ai] = A.v_now[ai]; // reserve current vertex
+        A.ott_next[ai] = A.ott_now[ai]; 
 
-        reserved_nodes[ai->id] = u;
+        reserved_nodes[ai] = u;
         }
     }
 
     // compute action for the other agent involved in swap
-    if (m == 0 && swap_agent != nullptr && swap_agent->v_next == nullptr && 
-        (occupied_next[ai->v_now->id] == nullptr or occupied_next[ai->v_now->id] == ai)) {
-        std::cout << "-----compute action for swap agent----- " << std::endl;
-        swap_agent->swap_completed = false;
-        swap_agent->v_next = ai->v_now;
-        occupied_next[swap_agent->v_next->id] = swap_agent;
+    if (m == 0 && swap_agent != NIL && A.v_next[swap_agent] == nullptr && 
+        (occupied_next[A.v_now[ai]->id] == NIL or occupied_next[A.v_now[ai]->id] == ai)) {
+        TRACE_FULL("compute action of swap agent:", swap_agent);
+        A.swap_completed[swap_agent] = false;
+        A.v_next[swap_agent] = A.v_now[ai];
+        occupied_next.set(A.v_next[swap_agent]->id, swap_agent);
         auto [next_node_swap_agent, next_orientation_swap_agent] = solution.computeAction(
-        swap_agent->v_now,
-        swap_agent->v_next,           
-        SAFE_VALUE(swap_agent->ott_now, swap_agent->id)  
+        A.v_now[swap_agent],
+        A.v_next[swap_agent],           
+        A.ott_now[swap_agent]  
         );
 
-        if (next_node_swap_agent == swap_agent->v_now) {
-            occupied_next[swap_agent->v_next->id] = nullptr;
-            swap_agent->v_next = swap_agent->v_now;
-            occupied_next[swap_agent->v_next->id] = swap_agent;
-            swap_agent->ott_next = next_orientation_swap_agent;
-            reserved_nodes[swap_agent->id] = nullptr;
-            if (next_orientation_swap_agent != swap_agent->ott_now){
-                reserved_nodes[swap_agent->id] = ai->v_now; 
+        if (next_node_swap_agent == A.v_now[swap_agent]) {
+            occupied_next.set(A.v_next[swap_agent]->id, NIL);
+            A.v_next[swap_agent] = A.v_now[swap_agent];
+            occupied_next.set(A.v_next[swap_agent]->id, swap_agent);
+            A.ott_next[swap_agent] = next_orientation_swap_agent;
+            reserved_nodes[swap_agent] = nullptr;
+            if (next_orientation_swap_agent != A.ott_now[swap_agent]){
+                reserved_nodes[swap_agent] = A.v_now[ai]; 
             }
         }
         else {
-            swap_agent->v_next = next_node_swap_agent;
-            swap_agent->ott_next = next_orientation_swap_agent;
-            occupied_next[swap_agent->v_next->id] = swap_agent;
-            reserved_nodes[swap_agent->id] = nullptr;
-            swap_agent->swap_completed = true;
+            A.v_next[swap_agent] = next_node_swap_agent;
+            A.ott_next[swap_agent] = next_orientation_swap_agent;
+            occupied_next.set(A.v_next[swap_agent]->id, swap_agent);
+            reserved_nodes[swap_agent] = nullptr;
+            A.swap_completed[swap_agent] = true;
         }
 
-        if (ai->v_next == ai->v_now) {
-            if(next_node_swap_agent!=swap_agent->v_now){
-            occupied_next[swap_agent->v_now->id] = swap_agent;
-            swap_agent->v_next = swap_agent->v_now;
-            swap_agent->ott_next = swap_agent->ott_now; 
+        if (A.v_next[ai] == A.v_now[ai]) {
+            if(next_node_swap_agent!=A.v_now[swap_agent]){
+            occupied_next.set(A.v_now[swap_agent]->id, swap_agent);
+            A.v_next[swap_agent] = A.v_now[swap_agent];
+            A.ott_next[swap_agent] = A.ott_now[swap_agent]; 
             
-            reserved_nodes[swap_agent->id] = ai->v_now;
+            reserved_nodes[swap_agent] = A.v_now[ai];
             }
         }         
     }
@@ -371,33 +425,15 @@ bool PIBT::funcPIBT(Agent* ai, Agent* aj, bool is_initial)
 
 
   // failed to secure node
-  //std::cout << "invalid" << aj->id << std::endl;
-  occupied_next[ai->v_now->id] = ai;
-  ai->v_next = ai->v_now;
-  ai->ott_next = ai->ott_now;
+  TRACE_EVENT("invalid, agent:", ai, "requester:", aj);
+  occupied_next.set(A.v_now[ai]->id, ai);
+  A.v_next[ai] = A.v_now[ai];
+  A.ott_next[ai] = A.ott_now[ai];
   return false;
 }
 
 float PIBT::getMinDistToGoal(int agent_id, Node* node, Orientation current_dir) {
-    float min_dist = std::numeric_limits<float>::max();
-    for (Orientation goal_dir : {Orientation::X_PLUS, Orientation::X_MINUS, 
-                                Orientation::Y_PLUS, Orientation::Y_MINUS}) {
-        float dist = pathDist(agent_id, node, current_dir);
-        min_dist = std::min(min_dist, dist);
-    }
-    return min_dist;
-}
-
-float PIBT::getMinDistAllDirections(int agent_id, Node* node) {
-    float min_dist = std::numeric_limits<float>::max();
-    
-    // 遍历当前节点的所有可能方向
-    for (Orientation current_dir : {Orientation::X_PLUS, Orientation::X_MINUS, 
-                                  Orientation::Y_PLUS, Orientation::Y_MINUS}) {
-        float dist = getMinDistToGoal(agent_id, node, current_dir);
-        min_dist = std::min(min_dist, dist);
-    }
-    return min_dist;
+    return pathDist(agent_id, node, current_dir);
 }
 
 // check whether all agents in cycle is heading to their requesting node
@@ -405,35 +441,27 @@ float PIBT::getMinDistAllDirections(int agent_id, Node* node) {
 void PIBT::handleCycleWithOrientation() {
     //std::cout << "Cycle detected at timestep " << solution.getMakespan() << std::endl;
     
-    if (request_chain.empty()) {
-        std::cout << "[Error] Empty request chain" << std::endl;
-        return;
-    }
+    TRACE_ASSERT(!request_chain.empty(), "empty request chain");
+    if (request_chain.empty()) return;
     
     bool all_oriented_correctly = true;
     std::vector<bool> correct_orientations(request_chain.size());
     
     // check the orientation of all agents in the cycle
     for (size_t i = 0; i < request_chain.size(); ++i) {
-        Agent* current_agent = request_chain[i].agent;
+        const int current_agent = request_chain[i].agent;
         Node* requested_node = request_chain[i].requested_node;
         
-        if (!current_agent || !requested_node || !current_agent->v_now) {
-            std::cout << "[Error] Invalid vertex in request chain" << std::endl;
+        TRACE_ASSERT(current_agent != NIL && requested_node,
+                     "invalid vertex in request chain");
+        if (current_agent == NIL || !requested_node) {
             continue;
         }
 
         Orientation target_orientation = solution.getRelativePosition(
-            current_agent->v_now, requested_node);  
+            A.v_now[current_agent], requested_node);  
               
-        if (!current_agent->ott_now.has_value()) {
-            std::cout << "[Error] Agent " << current_agent->id << " has no orientation" << std::endl;
-            all_oriented_correctly = false;
-            correct_orientations[i] = false;
-            continue;
-        }
-        
-        correct_orientations[i] = (SAFE_VALUE(current_agent->ott_now, current_agent->id) == target_orientation);
+        correct_orientations[i] = (A.ott_now[current_agent] == target_orientation);
         if (!correct_orientations[i]) {
             all_oriented_correctly = false;
         }
@@ -442,71 +470,61 @@ void PIBT::handleCycleWithOrientation() {
     if (!all_oriented_correctly) {
         // adjust the orientation if needed
         for (size_t i = 0; i < request_chain.size(); ++i) {
-            Agent* current_agent = request_chain[i].agent;
+            const int current_agent = request_chain[i].agent;
             Node* requested_node = request_chain[i].requested_node;
 
-            if (!current_agent->ott_now.has_value()) {
-            std::cout << "[Error] Agent " << current_agent->id 
-                      << " has no orientation in cycle handling!" << std::endl;
-            }
-            
             if (!correct_orientations[i]) {
-                if (!current_agent->ott_now.has_value()) {
-                    current_agent->ott_now = Orientation::Y_MINUS;
-                }
-
                 auto [next_node, next_orientation] = solution.computeAction(
-                    current_agent->v_now,
+                    A.v_now[current_agent],
                     requested_node,
-                    SAFE_VALUE(current_agent->ott_now, current_agent->id)
+                    A.ott_now[current_agent]
                 );
                 
-                current_agent->v_next = current_agent->v_now;
-                current_agent->ott_next = next_orientation;
-                occupied_next[current_agent->v_now->id] = current_agent;
+                A.v_next[current_agent] = A.v_now[current_agent];
+                A.ott_next[current_agent] = next_orientation;
+                occupied_next.set(A.v_now[current_agent]->id, current_agent);
             } else {
                 // hold current vertex and orientation
-                current_agent->v_next = current_agent->v_now;
-                current_agent->ott_next = current_agent->ott_now;
-                occupied_next[current_agent->v_now->id] = current_agent;
+                A.v_next[current_agent] = A.v_now[current_agent];
+                A.ott_next[current_agent] = A.ott_now[current_agent];
+                occupied_next.set(A.v_now[current_agent]->id, current_agent);
             }
         }
     } else {
         // all agents in cycle are facing to their desired node, then moving forward
         for (size_t i = 0; i < request_chain.size(); ++i) {
-            Agent* current_agent = request_chain[i].agent;
+            const int current_agent = request_chain[i].agent;
             Node* requested_node = request_chain[i].requested_node;
             
-            current_agent->v_next = requested_node;
-            current_agent->ott_next = current_agent->ott_now;
-            occupied_next[requested_node->id] = current_agent;
+            A.v_next[current_agent] = requested_node;
+            A.ott_next[current_agent] = A.ott_now[current_agent];
+            occupied_next.set(requested_node->id, current_agent);
         }
     }
 }
 
-auto PIBT::swap_possible_and_required(Agent* ai, const Nodes& C) -> Agent*
+int PIBT::swap_possible_and_required(const int ai, const Nodes& C)
 {
-    const auto i = ai->id;
-    if (C[0] == ai->v_now) return nullptr;
+    if (C[0] == A.v_now[ai]) return NIL;
 
     auto aj = occupied_now[C[0]->id];
-    if (aj != nullptr && aj->v_next == nullptr &&
-        // is_swap_required(ai->id, aj->id, ai->v_now, aj->v_now) &&
-        is_swap_required(ai->id, aj->id, ai->v_now, aj->v_now) &&
-        is_swap_possible(aj->v_now, ai->v_now)) {
+    if (aj != NIL && A.v_next[aj] == nullptr &&
+        // is_swap_required(ai, aj, A.v_now[ai], A.v_now[aj]) &&
+        is_swap_required(ai, aj, A.v_now[ai], A.v_now[aj]) &&
+        is_swap_possible(A.v_now[aj], A.v_now[ai])) {
         return aj;
     }
 
-    for (auto u : ai->v_now->neighbor) {
+    for (auto u : A.v_now[ai]->neighbor) {
         auto ak = occupied_now[u->id];
-        if (ak == nullptr || C[0] == ak->v_now) continue;
-        // if (is_swap_required(ak->id, ai->id, ai->v_now, C[0]) &&
-        if (is_swap_required(ak->id, ai->id, ai->v_now, C[0]) &&
-            is_swap_possible(C[0], ai->v_now)) {
+        if (ak == NIL || C[0] == A.v_now[ak]) continue;
+        // if (is_swap_required(ak, ai, A.v_now[ai], C[0]) &&
+        if (is_swap_required(ak, ai, A.v_now[ai], C[0]) &&
+            is_swap_possible(C[0], A.v_now[ai])) {
             return ak;
         }
     }
-    return nullptr;
+    return NIL;
 }
 
 bool PIBT::is_swap_required(const int pusher, const int puller,
@@ -516,13 +534,25 @@ bool PIBT::is_swap_required(const int pusher, const int puller,
     auto v_puller = v_puller_origin;
     Node* tmp = nullptr;
 
-    while (getMinDistAllDirections(pusher, v_puller) < 
-           getMinDistAllDirections(pusher, v_pusher)) {
+    while (pathDistAnyDir(pusher, v_puller) < 
+           pathDistAnyDir(pusher, v_pusher)) {
+        // no branch in a corridor, and the distance keeps decreasing until
+        // the junction at its end unless the goal lies on the way
+        if (G->getCorridorId(v_puller) != -1) {
+            auto [v_last, v_next] = G->passCorridor(v_pusher, v_puller);
+            if (v_next != nullptr &&
+                !G->isOnCorridorSection(A.g[pusher], v_puller, v_last)) {
+                v_pusher = v_last;
+                v_puller = v_next;
+                continue;
+            }
+        }
+
         auto n = v_puller->neighbor.size();
         for (auto u : v_puller->neighbor) {
             auto a = occupied_now[u->id];
             if (u == v_pusher ||
-                (u->neighbor.size() == 1 && a != nullptr && a->g == u)) {
+                (u->neighbor.size() == 1 && a != NIL && A.g[a] == u)) {
                 --n;
             } else {
                 tmp = u;
@@ -534,11 +564,11 @@ bool PIBT::is_swap_required(const int pusher, const int puller,
         v_puller = tmp;
     }
 
-    return (getMinDistAllDirections(puller, v_pusher) < 
-            getMinDistAllDirections(puller, v_puller)) &&
-           (getMinDistAllDirections(pusher, v_pusher) == 0 ||
-            getMinDistAllDirections(pusher, v_puller) < 
-            getMinDistAllDirections(pusher, v_pusher));
+    return (pathDistAnyDir(puller, v_pusher) < 
+            pathDistAnyDir(puller, v_puller)) &&
+           (pathDistAnyDir(pusher, v_pusher) == 0 ||
+            pathDistAnyDir(pusher, v_puller) < 
+            pathDistAnyDir(pusher, v_pusher));
 }
 
 
@@ -549,11 +579,24 @@ bool PIBT::is_swap_possible(Node* v_pusher_origin, Node* v_puller_origin)
     Node* tmp = nullptr;
 
     while (v_puller != v_pusher_origin) {
+        // no branch in a corridor, the walk is forced until its end
+        if (G->getCorridorId(v_puller) != -1) {
+            auto [v_last, v_next] = G->passCorridor(v_pusher, v_puller);
+            // dead end, cyclic corridor, or back to the origin
+            if (v_next == nullptr ||
+                G->isOnCorridorSection(v_pusher_origin, v_puller, v_last)) {
+                return false;
+            }
+            v_pusher = v_last;
+            v_puller = v_next;
+            continue;
+        }
+
         auto n = v_puller->neighbor.size();
         for (auto u : v_puller->neighbor) {
             auto a = occupied_now[u->id];
             if (u == v_pusher ||
-                (u->neighbor.size() == 1 && a != nullptr && a->g == u)) {
+                (u->neighbor.size() == 1 && a != NIL && A.g[a] == u)) {
                 --n;
             } else {
                 tmp = u;
@@ -567,17 +610,31 @@ bool PIBT::is_swap_possible(Node* v_pusher_origin, Node* v_puller_origin)
     return false;
 }
 
-void PIBT::updatePushCount(int pushed_agent_id, int pusher_id) {
-    if (pushed_agent_id >= 0 && pushed_agent_id < (int)push_count_table.size() &&
-        pusher_id >= 0 && pusher_id < (int)push_count_table[0].size()) {
-        push_count_table[pushed_agent_id][pusher_id]++;
+auto PIBT::findPushRecord(int pushed_agent_id, int pusher_id) -> PushRecord*
+{
+    auto records = &push_history[pushed_agent_id * PUSH_HISTORY_SIZE];
+    for (int k = 0; k < PUSH_HISTORY_SIZE; ++k) {
+        if (records[k].pusher == pusher_id) return &records[k];
     }
+    return nullptr;
+}
+
+void PIBT::updatePushCount(int pushed_agent_id, int pusher_id) {
+    auto record = findPushRecord(pushed_agent_id, pusher_id);
+    if (record == nullptr) {
+        // overwrite the oldest pusher
+        int& head = push_history_head[pushed_agent_id];
+        record = &push_history[pushed_agent_id * PUSH_HISTORY_SIZE + head];
+        *record = PushRecord{pusher_id, 0};
+        head = (head + 1) % PUSH_HISTORY_SIZE;
+    }
+    ++record->count;
 }
 
 int PIBT::getPushCount(int pushed_agent_id, int pusher_id) const {
-    if (pushed_agent_id >= 0 && pushed_agent_id < (int)push_count_table.size() &&
-        pusher_id >= 0 && pusher_id < (int)push_count_table[0].size()) {
-        return push_count_table[pushed_agent_id][pusher_id];
+    auto records = &push_history[pushed_agent_id * PUSH_HISTORY_SIZE];
+    for (int k = 0; k < PUSH_HISTORY_SIZE; ++k) {
+        if (records[k].pusher == pusher_id) return records[k].count;
     }
     return 0;
 }
@@ -585,21 +642,22 @@ int PIBT::getPushCount(int pushed_agent_id, int pusher_id) const {
 void PIBT::printPushCountTable() const {
     std::cout << "Push Count Table:" << std::endl;
     std::cout << "Format: [pushed_agent_id][pusher_id] = count" << std::endl;
-    for (size_t i = 0; i < push_count_table.size(); ++i) {
-        for (size_t j = 0; j < push_count_table[i].size(); ++j) {
-            if (push_count_table[i][j] > 0) {
-                std::cout << "[" << i << "][" << j << "] = " 
-                         << push_count_table[i][j] << std::endl;
-            }
+    for (size_t k = 0; k < push_history.size(); ++k) {
+        const auto& record = push_history[k];
+        if (record.pusher != NIL && record.count > 0) {
+            std::cout << "[" << k / PUSH_HISTORY_SIZE << "][" << record.pusher
+                      << "] = " << record.count << std::endl;
         }
     }
 }
 
 void PIBT::PushEscapeTrigger(Nodes& C, int pushed_agent_id, int pusher_id) {
-    int push_time = getPushCount(pushed_agent_id, pusher_id);
-    if (push_time >= 2 && C.size() > 1) { // change k value here
+    auto record = findPushRecord(pushed_agent_id, pusher_id);
+    if (record == nullptr) return;
+    if (record->count >= 2 && C.size() > 1) { // change k value here
         std::shuffle(C.begin(), C.end(), *MT);
-        push_count_table[pushed_agent_id][pusher_id] = 0;
+        record->count = 0;
+        ++metrics.push_escapes;
     }
 }
 
@@ -608,15 +666,27 @@ void PIBT::setParams(int argc, char* argv[])
 {
   struct option longopts[] = {
       {"disable-dist-init", no_argument, 0, 'd'},
+      {"metrics", required_argument, 0, 'm'},
+      {"livelock-window", required_argument, 0, 'w'},
       {0, 0, 0, 0},
   };
   optind = 1;  // reset
   int opt, longindex;
-  while ((opt = getopt_long(argc, argv, "d", longopts, &longindex)) != -1) {
+  while ((opt = getopt_long(argc, argv, "dm:w:", longopts, &longindex)) != -1) {
     switch (opt) {
       case 'd':
         disable_dist_init = true;
         break;
+      case 'w':
+        livelock_window = std::atoi(optarg);
+        if (livelock_window < 0) halt("livelock window must be >= 0");
+        break;
+      case 'm':
+        metrics_format = std::string(optarg);
+        if (metrics_format != "csv" && metrics_format != "json") {
+          halt("unknown metrics format, " + metrics_format);
+        }
+        break;
       default:
         break;
     }
@@ -629,5 +699,82 @@ void PIBT::printHelp()
             << "  -d --disable-dist-init"
             << "        "
             << "disable initialization of priorities "
-            << "using distance from starts to goals" << std::endl;
+            << "using distance from starts to goals"
+            << "\n  -m --metrics [csv|json]"
+            << "       "
+            << "output per-timestep metrics next to the result file"
+            << "\n  -w --livelock-window [INT]"
+            << "    "
+            << "stop when at least half of the last INT configurations "
+            << "already appeared within them"
+            << std::endl;
+}
+
+void PIBT::makeLog(const std::string& logfile)
+{
+  MAPF_Solver::makeLog(logfile);
+  if (!metrics_format.empty()) makeLogMetrics(logfile);
+}
+
+void PIBT::makeLogBasicInfo(std::ostream& log)
+{
+  MAPF_Solver::makeLogBasicInfo(log);
+  if (livelock_window > 0) log << "livelock_period=" << livelock_period << "\n";
+}
+
+std::string PIBT::getMetricsFileName(const std::string& logfile,
+                                     const std::string& format)
+{
+  auto pos_dot = logfile.find_last_of('.');
+  auto pos_slash = logfile.find_last_of('/');
+  if (pos_dot == std::string::npos ||
+      (pos_slash != std::string::npos && pos_dot < pos_slash)) {
+    pos_dot = logfile.size();
+  }
+  return logfile.substr(0, pos_dot) + "_metrics." + format;
+}
+
+void PIBT::makeLogMetrics(const std::string& logfile) const
+{
+  std::ofstream log(getMetricsFileName(logfile, metrics_format),
+                    std::ios::out);
+  // values at t are of the planning from timestep t to t+1
+  static const std::vector<std::string> KEYS = {
+      "timestep",     "funcpibt_calls", "max_depth",     "cycles", "swaps",
+      "push_escapes", "rotations",      "forward_moves", "latency_us"};
+  const int keys_size = KEYS.size();
+  const int timesteps = metrics_hist.size();
+  auto getValues = [&](const int t) {
+    const auto& m = metrics_hist[t];
+    return std::vector<int>{t,
+                            m.funcpibt_calls,
+                            m.max_depth,
+                            m.cycles,
+                            m.swaps,
+                            m.push_escapes,
+                            m.rotations,
+                            m.forward_moves,
+                            m.latency_us};
+  };
+
+  if (metrics_format == "csv") {
+    for (int k = 0; k < keys_size; ++k) log << (k > 0 ? "," : "") << KEYS[k];
+    log << "\n";
+    for (int t = 0; t < timesteps; ++t) {
+      auto values = getValues(t);
+      for (int k = 0; k < keys_size; ++k) log << (k > 0 ? "," : "") << values[k];
+      log << "\n";
+    }
+  } else {
+    log << "[";
+    for (int t = 0; t < timesteps; ++t) {
+      auto values = getValues(t);
+      log << (t > 0 ? ",\n " : "\n ") << "{";
+      for (int k = 0; k < keys_size; ++k) {
+        log << (k > 0 ? ", " : "") << "\"" << KEYS[k] << "\": " << values[k];
+      }
+      log << "}";
+    }
+    log << "\n]\n";
+  }
 }
@@ -50,6 +50,19 @@ void PIBT_MAPD::run()
          a->task->loc_pickup->id, " -> ", a->task->loc_delivery->id);
   };
 
+  // elapsed and whether assigned or not of each agent
+  // when the priorities were sorted last time
+  std::vector<int> elapsed_sorted(P->getNum(), 0);
+  std::vector<bool> assigned_sorted(P->getNum(), false);
+  auto getRun = [&](Agent* a) {
+    if ((a->task != nullptr) != assigned_sorted[a->id]) return -1;
+    const int e = elapsed_sorted[a->id];
+    if (a->elapsed == e + 1) return 0;        // incremented
+    if (a->elapsed == 0 && e == 0) return 1;  // stay at goal
+    return -1;                                // reached goal
+  };
+  bool first_step = true;
+
   // main loop
   while (true) {
     info(" ", "elapsed:", getSolverElapsedTime(),
@@ -109,12 +122,20 @@ void PIBT_MAPD::run()
 
       hist_targets.push_back(targets);
       hist_tasks.push_back(tasks);
+      appendLog();
     }
 
-    // planning
+    // planning, priorities are sorted incrementally after the first step
     {
-      std::sort(A.begin(), A.end(), compare);
+      if (first_step) {
+        std::sort(A.begin(), A.end(), compare);
+        first_step = false;
+      } else {
+        resortRuns(A, 2, compare, getRun);
+      }
       for (auto a : A) {
+        elapsed_sorted[a->id] = a->elapsed;
+        assigned_sorted[a->id] = (a->task != nullptr);
         // if the agent has next location, then skip
         if (a->v_next == nullptr) {
           // determine its next location
@@ -188,6 +209,7 @@ void PIBT_MAPD::run()
     }
     hist_targets.push_back(targets);
     hist_tasks.push_back(tasks);
+    appendLog();
   }
 
   // memory clear
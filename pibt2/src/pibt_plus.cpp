@@ -1,5 +1,7 @@
 #include "../include/pibt_plus.hpp"
 
+#include <getopt.h>
+
 #include <fstream>
 #include <memory>
 
@@ -12,6 +14,8 @@ PIBT_PLUS::PIBT_PLUS(MAPF_Instance* _P) : MAPF_Solver(_P)
 {
   solver_name = SOLVER_NAME;
   comp_time_complement = 0;
+  livelock_window = 0;
+  livelock_period = 0;
 }
 
 void PIBT_PLUS::run()
@@ -26,11 +30,12 @@ void PIBT_PLUS::run()
   auto _P = MAPF_Instance(P, P->getConfigStart(), P->getConfigGoal(),
                           max_comp_time, LB_makespan);
   auto init_solver = std::make_unique<PIBT>(&_P);
-  init_solver->setDistanceTable(
-      (distance_table_p == nullptr) ? &distance_table : distance_table_p);
+  init_solver->setDistanceTable(getDistanceTable());
+  init_solver->setLivelockWindow(livelock_window);
   info(" ", "run PIBT until timestep", LB_makespan);
   init_solver->solve();
   solution = init_solver->getSolution();
+  livelock_period = init_solver->getLivelockPeriod();
 
   if (init_solver->succeed()) {  // PIBT success
     solved = true;
@@ -45,8 +50,7 @@ void PIBT_PLUS::run()
     auto comp_solver = std::make_shared<PushAndSwap>(&_Q);
 
     // set solver options
-    comp_solver->setDistanceTable(
-        (distance_table_p == nullptr) ? &distance_table : distance_table_p);
+    comp_solver->setDistanceTable(getDistanceTable());
 
     info(" ", "elapsed:", getSolverElapsedTime(), ", use",
          comp_solver->getSolverName(), "to complement the remain");
@@ -60,21 +64,41 @@ void PIBT_PLUS::run()
   }
 }
 
+void PIBT_PLUS::setParams(int argc, char* argv[])
+{
+  struct option longopts[] = {
+      {"livelock-window", required_argument, 0, 'w'},
+      {0, 0, 0, 0},
+  };
+  optind = 1;  // reset
+  int opt, longindex;
+  while ((opt = getopt_long(argc, argv, "w:", longopts, &longindex)) != -1) {
+    switch (opt) {
+      case 'w':
+        livelock_window = std::atoi(optarg);
+        if (livelock_window < 0) halt("livelock window must be >= 0");
+        break;
+      default:
+        break;
+    }
+  }
+}
+
 void PIBT_PLUS::printHelp()
 {
   std::cout << PIBT_PLUS::SOLVER_NAME << "\n"
-            << "  (none)" << std::endl;
+            << "  -w --livelock-window [INT]"
+            << "    "
+            << "use Push & Swap as soon as at least half of the last INT "
+            << "configurations of PIBT already appeared within them"
+            << std::endl;
 }
 
-void PIBT_PLUS::makeLog(const std::string& logfile)
+void PIBT_PLUS::makeLogBasicInfo(std::ostream& log)
 {
-  std::ofstream log;
-  log.open(logfile, std::ios::out);
-  makeLogBasicInfo(log);
+  MAPF_Solver::makeLogBasicInfo(log);
 
   // print additional info
   log << "comp_time_complement=" << comp_time_complement << "\n";
-
-  makeLogSolution(log);
-  log.close();
+  if (livelock_window > 0) log << "livelock_period=" << livelock_period << "\n";
 }
@@ -1,18 +1,119 @@
 #include "../include/plan.hpp"
 
+void Plan::setKeyframeInterval(const int k)
+{
+  if (!empty()) halt("keyframe interval must be set for an empty plan");
+  if (k < 0) halt("invalid keyframe interval");
+  keyframe_interval = k;
+}
+
+void Plan::checkTimestep(const int t) const
+{
+  if (!(0 <= t && t < plan_size)) halt("invalid timestep");
+}
+
+const int* Plan::storedIds(const int t) const
+{
+  if (keyframe_interval == 0) {
+    return node_ids.data() + (std::size_t)t * num_agents;
+  }
+  if (t == plan_size - 1) return last_ids.data();
+  return node_ids.data() + (std::size_t)(t / keyframe_interval) * num_agents;
+}
+
+const std::uint8_t* Plan::storedOtts(const int t) const
+{
+  if (keyframe_interval == 0) {
+    return packed_otts.data() + (std::size_t)t * orientation_bytes;
+  }
+  if (t == plan_size - 1) return last_otts.data();
+  return packed_otts.data() +
+         (std::size_t)(t / keyframe_interval) * orientation_bytes;
+}
+
+void Plan::restoreRow(const int t, Cursor& cursor) const
+{
+  // continue from the cursor when it is between the keyframe and t
+  const int t_key = t - t % keyframe_interval;
+  int t_from = cursor.t;
+  if (!(t_key <= cursor.t && cursor.t <= t)) {
+    const int* ids = storedIds(t_key);
+    const std::uint8_t* otts = storedOtts(t_key);
+    cursor.ids.assign(ids, ids + num_agents);
+    cursor.otts.assign(otts, otts + orientation_bytes);
+    t_from = t_key;
+  }
+  for (int k = change_offsets[t_from + 1]; k < change_offsets[t + 1]; ++k) {
+    const int i = changes[k].agent_ott >> 2;
+    cursor.ids[i] = changes[k].node_id;
+    pack(cursor.otts.data(), i, changes[k].agent_ott & 3);
+  }
+  cursor.t = t;
+}
+
+const Plan::Change* Plan::findChange(const int t, const int i) const
+{
+  const std::uint32_t key = std::uint32_t(i) << 2;
+  for (int s = t; !isKeyframe(s); --s) {
+    auto first = changes.begin() + change_offsets[s];
+    auto last = changes.begin() + change_offsets[s + 1];
+    auto itr = std::lower_bound(
+        first, last, key,
+        [](const Change& c, const std::uint32_t k) { return c.agent_ott < k; });
+    if (itr != last && (itr->agent_ott >> 2) == key >> 2) return &*itr;
+  }
+  return nullptr;
+}
+
+Span<const int> Plan::getNodeIds(const int t) const
+{
+  checkTimestep(t);
+  if (!isStored(t)) halt("row is not stored, use a cursor");
+  return {storedIds(t), num_agents};
+}
+
+Span<const int> Plan::getNodeIds(const int t, Cursor& cursor) const
+{
+  checkTimestep(t);
+  if (isStored(t)) return {storedIds(t), num_agents};
+  if (cursor.t != t) restoreRow(t, cursor);
+  return {cursor.ids.data(), num_agents};
+}
+
+Span<const std::uint8_t> Plan::getPackedOrientations(const int t) const
+{
+  checkTimestep(t);
+  if (!isStored(t)) halt("row is not stored, use a cursor");
+  return {storedOtts(t), orientation_bytes};
+}
+
+Span<const std::uint8_t> Plan::getPackedOrientations(const int t,
+                                                     Cursor& cursor) const
+{
+  checkTimestep(t);
+  if (isStored(t)) return {storedOtts(t), orientation_bytes};
+  if (cursor.t != t) restoreRow(t, cursor);
+  return {cursor.otts.data(), orientation_bytes};
+}
+
 Config Plan::get(const int t) const
 {
-  const int configs_size = configs.size();
-  if (!(0 <= t && t < configs_size)) halt("invalid timestep");
-  return configs[t];
+  Cursor cursor;
+  auto ids = getNodeIds(t, cursor);
+  Config c(num_agents);
+  for (int i = 0; i < num_agents; ++i) c[i] = toNode(ids[i]);
+  return c;
 }
 
 Node* Plan::get(const int t, const int i) const
 {
   if (empty()) halt("invalid operation");
-  if (!(0 <= t && t < (int)configs.size())) halt("invalid timestep");
-  if (!(0 <= i && i < (int)configs[0].size())) halt("invalid agent id");
-  return configs[t][i];
+  checkTimestep(t);
+  if (!(0 <= i && i < num_agents)) halt("invalid agent id");
+  if (isStored(t)) return toNode(storedIds(t)[i]);
+  auto change = findChange(t, i);
+  if (change != nullptr) return toNode(change->node_id);
+  return toNode(storedIds(t - t % keyframe_interval)[i]);
 }
 
 Path Plan::getPath(const int i) const
@@ -25,74 +126,71 @@ Path Plan::getPath(const int i) const
 
 // test with orientation
 void Plan::addOrientation(const std::vector<Orientation>& orients) {
-    if (configs.empty()) {
+    if (empty()) {
         halt("invalid operation: cannot add orientation before config");
     }
-    if (orients.size() != configs.back().size()) {
+    if ((int)orients.size() != num_agents) {
         halt("invalid orientation operation");
     }
-    orientations.back() = orients;
+    // rewrite orientations of the last configuration
+    const int t = plan_size - 1;
+    if (isKeyframe(t)) {
+      auto otts = &packed_otts[packed_otts.size() - orientation_bytes];
+      for (int i = 0; i < num_agents; ++i) pack(otts, i, toIndex(orients[i]));
+    }
+    if (keyframe_interval > 0) {
+      for (int i = 0; i < num_agents; ++i) {
+        pack(last_otts.data(), i, toIndex(orients[i]));
+      }
+      if (!isKeyframe(t)) {
+        // changes from the previous timestep
+        changes.resize(change_offsets[t]);
+        Cursor cursor;
+        auto ids_prev = getNodeIds(t - 1, cursor);
+        auto otts_prev = getPackedOrientations(t - 1, cursor);
+        for (int i = 0; i < num_agents; ++i) {
+          if (ids_prev[i] != last_ids[i] ||
+              unpack(otts_prev.begin(), i) != orients[i]) {
+            changes.push_back(
+                {(std::uint32_t(i) << 2) | std::uint32_t(toIndex(orients[i])),
+                 last_ids[i]});
+          }
+        }
+        change_offsets[t + 1] = changes.size();
+      }
+    }
 }
 
 Orientation Plan::getOrientation(const int t, const int i) const {
-    if (orientations.empty()) halt("invalid orientation operation");
-    if (!(0 <= t && t < (int)orientations.size())) halt("invalid timestep");
-    if (!(0 <= i && i < (int)orientations[0].size())) halt("invalid agent id");
-    return orientations[t][i];
+    if (empty()) halt("invalid orientation operation");
+    checkTimestep(t);
+    if (!(0 <= i && i < num_agents)) halt("invalid agent id");
+    if (isStored(t)) return unpack(storedOtts(t), i);
+    auto change = findChange(t, i);
+    if (change != nullptr) {
+      return static_cast<Orientation>(change->agent_ott & 3);
+    }
+    return unpack(storedOtts(t - t % keyframe_interval), i);
 }
 
 std::vector<Orientation> Plan::getOrientations(const int t) const {
-    if (!(0 <= t && t < (int)orientations.size())) halt("invalid timestep");
-    return orientations[t];
+    Cursor cursor;
+    auto otts = getPackedOrientations(t, cursor);
+    std::vector<Orientation> orients(num_agents);
+    for (int i = 0; i < num_agents; ++i) orients[i] = unpack(otts.begin(), i);
+    return orients;
 }
 
 
-//
+// O(1) by adjacency indexed by orientation
 Orientation Plan::getRelativePosition(Node* current, Node* target) const {
-    bool is_neighbor = false;
-    for (auto& n : current->neighbor) {
-        if (n == target) {
-            is_neighbor = true;
-            break;
-        }
-    }
-    if (!is_neighbor) {
-        halt("Nodes are not neighbors");
-    }
-
-    // relative position
-    if (target->pos.x > current->pos.x) return Orientation::X_PLUS;
-    if (target->pos.x < current->pos.x) return Orientation::X_MINUS;
-    if (target->pos.y > current->pos.y) return Orientation::Y_PLUS;
-    if (target->pos.y < current->pos.y) return Orientation::Y_MINUS;
-    
-    halt("Invalid position relationship");
-    return Orientation::X_PLUS;
+    auto dir = getRelativeOrientation(current, target);
+    if (!dir) halt("Nodes are not neighbors");
+    return *dir;
 }
 
 int Plan::getAngleDifference(Orientation dir1, Orientation dir2) const {
-    const std::map<Orientation, int> dir_to_angle = {
-        {Orientation::X_PLUS, 0},
-        {Orientation::Y_PLUS, 90},
-        {Orientation::X_MINUS, 180},
-        {Orientation::Y_MINUS, 270}
-    };
-    
-    int angle1 = dir_to_angle.at(dir1);
-    int angle2 = dir_to_angle.at(dir2);
-    int diff = std::abs(angle1 - angle2);
-    return std::min(diff, 360 - diff);
-}
-
-Orientation Plan::rotateCounterClockwise(Orientation orient) const {
-    switch (orient) {
-        case Orientation::X_PLUS: return Orientation::Y_PLUS;
-        case Orientation::Y_PLUS: return Orientation::X_MINUS;
-        case Orientation::X_MINUS: return Orientation::Y_MINUS;
-        case Orientation::Y_MINUS: return Orientation::X_PLUS;
-        default: halt("Invalid orientation");
-    }
-    return Orientation::X_PLUS; 
+    return ::getAngleDifference(dir1, dir2);
 }
 
 std::pair<Node*, Orientation> Plan::computeAction(
@@ -103,38 +201,22 @@ std::pair<Node*, Orientation> Plan::computeAction(
         return {current, current_orient};
     }
     
-    bool is_neighbor = false;
-    for (auto& n : current->neighbor) {
-        if (n == target) {
-            is_neighbor = true;
-            break;
-        }
-    }
-    if (!is_neighbor) {
+    auto relative_pos = getRelativeOrientation(current, target);
+    if (!relative_pos) {
         halt("Target node must be either current node or its neighbor");
     }
-
-    Orientation relative_pos = getRelativePosition(current, target);
-    
-    int angle_diff = getAngleDifference(current_orient, relative_pos);
     
-    if (angle_diff == 0) {
-        // move forward
-        return {target, relative_pos};
-    }
-    else if (angle_diff == 90) {
-        // adjust direction
-        return {current, relative_pos};
+    switch (::getAngleDifference(current_orient, *relative_pos)) {
+        case 0:
+            // move forward
+            return {target, *relative_pos};
+        case 90:
+            // adjust direction
+            return {current, *relative_pos};
+        default:
+            // adjust direction
+            return {current, rotateCounterClockwise(current_orient)};
     }
-    else if (angle_diff == 180) {
-        // adjust direction
-        return {current, rotateCounterClockwise(current_orient)};
-    }
-    else {
-        halt("Invalid angle difference");
-    }
-    
-    return {nullptr, Orientation::X_PLUS};
 }
 
 /*
@@ -245,62 +327,118 @@ std::optional<Action> Plan::getAndRemoveFirstAction(int agent_id, int timestep)
 Config Plan::last() const
 {
   if (empty()) halt("invalid operation");
-  return configs[getMakespan()];
+  return get(getMakespan());
 }
 
 Node* Plan::last(const int i) const
 {
   if (empty()) halt("invalid operation");
-  if (i < 0 || (int)configs[0].size() <= i) halt("invalid operation");
-  return configs[getMakespan()][i];
+  if (i < 0 || num_agents <= i) halt("invalid operation");
+  return toNode(getNodeIds(getMakespan())[i]);
 }
 
-void Plan::clear() { configs.clear(); orientations.clear();}
-
-void Plan::add(const Config& c)
+void Plan::clear()
+{
+  num_agents = 0;
+  plan_size = 0;
+  orientation_bytes = 0;
+  node_ids.clear();
+  packed_otts.clear();
+  changes.clear();
+  change_offsets.clear();
+  last_ids.clear();
+  last_otts.clear();
+  arrivals.clear();
+  soc = 0;
+  oriented = false;
+  occupancy_index.clear();
+  indexed_size = 0;
+}
+
+void Plan::append(const Node* const* c, const int c_size,
+                  const Orientation* orients)
 {
-  if (!configs.empty() && configs.at(0).size() != c.size()) {
+  if (empty()) {
+    num_agents = c_size;
+    orientation_bytes = (c_size + 3) / 4;
+    arrivals.assign(c_size, 0);
+    soc = 0;
+    if (keyframe_interval > 0) {
+      last_ids.assign(c_size, -1);
+      last_otts.assign(orientation_bytes, 0);
+      change_offsets.assign(1, 0);
+    }
+  } else if (num_agents != c_size) {
     halt("invalid operation");
   }
-  configs.push_back(c);
-  orientations.push_back(std::vector<Orientation>(c.size()));
+
+  const int t = plan_size;
+  const bool keyframe = isKeyframe(t);
+  if (keyframe) {
+    node_ids.resize(node_ids.size() + num_agents);
+    packed_otts.resize(packed_otts.size() + orientation_bytes, 0);
+  }
+  // after resizing, the previous row might be moved
+  const int* ids_prev = (t == 0) ? nullptr : storedIds(t - 1);
+  int* ids = keyframe ? &node_ids[node_ids.size() - num_agents] : nullptr;
+  std::uint8_t* otts =
+      keyframe ? &packed_otts[packed_otts.size() - orientation_bytes] : nullptr;
+
+  for (int i = 0; i < num_agents; ++i) {
+    const int id = (c[i] == nullptr) ? -1 : c[i]->id;
+    const int o = (orients == nullptr) ? 0 : toIndex(orients[i]);
+    if (id >= (int)nodes.size()) nodes.resize(id + 1, nullptr);
+    if (id >= 0) nodes[id] = const_cast<Node*>(c[i]);
+
+    // path cost, the agent stays at the last location after arrivals[i]
+    if (ids_prev != nullptr && ids_prev[i] != id) {
+      soc += t - arrivals[i];
+      arrivals[i] = t;
+    }
+
+    if (keyframe) {
+      ids[i] = id;
+      pack(otts, i, o);
+    }
+    if (keyframe_interval > 0) {
+      if (!keyframe &&
+          (last_ids[i] != id || toIndex(unpack(last_otts.data(), i)) != o)) {
+        changes.push_back({(std::uint32_t(i) << 2) | std::uint32_t(o), id});
+      }
+      last_ids[i] = id;
+      pack(last_otts.data(), i, o);
+    }
+  }
+  if (keyframe_interval > 0) change_offsets.push_back(changes.size());
+  oriented = (t == 0 || oriented) && orients != nullptr;
+  ++plan_size;
 }
 
+void Plan::add(const Config& c) { append(c.data(), c.size(), nullptr); }
+
 void Plan::addWithOrientation(const Config& c, const std::vector<Orientation>& orients) {
-  if (!configs.empty() && configs.at(0).size() != c.size()) {
+  if (!empty() && num_agents != (int)c.size()) {
     halt("invalid operation");
   }
   if (c.size() != orients.size()) {
     halt("invalid orientation size");
   }
-  configs.push_back(c);
-  orientations.push_back(orients);
+  append(c.data(), c.size(), orients.data());
 }
 
-bool Plan::empty() const { return configs.empty(); }
+bool Plan::empty() const { return plan_size == 0; }
 
-int Plan::size() const { return configs.size(); }
+int Plan::size() const { return plan_size; }
 
 int Plan::getMakespan() const { return size() - 1; }
 
 int Plan::getPathCost(const int i) const
 {
-  const int makespan = getMakespan();
-  const Node* g = get(makespan, i);
-  int c = makespan;
-  while (c > 0 && get(c - 1, i) == g) --c;
-  return c;
+  if (!(0 <= i && i < num_agents)) halt("invalid agent id");
+  return arrivals[i];
 }
 
-int Plan::getSOC() const
-{
-  int makespan = getMakespan();
-  if (makespan <= 0) return 0;
-  int num_agents = get(0).size();
-  int soc = 0;
-  for (int i = 0; i < num_agents; ++i) soc += getPathCost(i);
-  return soc;
-}
+int Plan::getSOC() const { return soc; }
 
 Plan Plan::operator+(const Plan& other) const
 {
@@ -314,30 +452,41 @@ Plan Plan::operator+(const Plan& other) const
     if (c1[i] != c2[i]) halt("invalid operation.");
   }
   // merge
-  Plan new_plan;
-  new_plan.configs = configs;
-  for (int t = 1; t < other.size(); ++t) new_plan.add(other.get(t));
+  Plan new_plan = *this;
+  new_plan += other;
   return new_plan;
 }
 
 void Plan::operator+=(const Plan& other)
 {
-  if (configs.empty()) {
-    configs = other.configs;
-    return;
-  }
+  if (other.empty()) return;
+  const int t_start = empty() ? 0 : 1;
   // check validity
-  if (!sameConfig(last(), other.get(0))) halt("invalid operation");
-  // merge
-  for (int t = 1; t < other.size(); ++t) add(other.get(t));
+  if (!empty() && !sameConfig(last(), other.get(0))) {
+    halt("invalid operation");
+  }
+  // merge, with orientations
+  Config c(other.num_agents);
+  std::vector<Orientation> orients(other.num_agents);
+  Cursor cursor;
+  for (int t = t_start; t < other.size(); ++t) {
+    auto ids = other.getNodeIds(t, cursor);
+    auto otts = other.getPackedOrientations(t, cursor);
+    for (int i = 0; i < other.num_agents; ++i) {
+      c[i] = other.toNode(ids[i]);
+      orients[i] = unpack(otts.begin(), i);
+    }
+    append(c.data(), c.size(), orients.data());
+  }
+  oriented = oriented && other.oriented;
 }
 
-bool Plan::validate(MAPF_Instance* P) const
+bool Plan::validate(MAPF_Instance* P, const int num_threads) const
 {
-  return validate(P->getConfigStart(), P->getConfigGoal());
+  return validate(P->getConfigStart(), P->getConfigGoal(), num_threads);
 }
 
-bool Plan::validate(MAPD_Instance* P) const
+bool Plan::validate(MAPD_Instance* P, const int num_threads) const
 {
   // check tasks
   if ((int)P->getOpenTasks().size() > 0) {
@@ -356,22 +505,23 @@ bool Plan::validate(MAPD_Instance* P) const
     return false;
   }
 
-  return validate(P->getConfigStart());
+  return validate(P->getConfigStart(), num_threads);
 }
 
-bool Plan::validate(const Config& starts, const Config& goals) const
+bool Plan::validate(const Config& starts, const Config& goals,
+                    const int num_threads) const
 {
   // check goal
   if (!sameConfig(last(), goals)) {
     warn("validation, invalid goals");
     return false;
   }
-  return validate(starts);
+  return validate(starts, num_threads);
 }
 
-bool Plan::validate(const Config& starts) const
+bool Plan::validate(const Config& starts, const int num_threads) const
 {
-  if (configs.empty()) return false;
+  if (empty()) return false;
 
   // start
   if (!sameConfig(starts, get(0))) {
@@ -379,54 +529,129 @@ bool Plan::validate(const Config& starts) const
     return false;
   }
 
-  // check conflicts and continuity
-  int num_agents = get(0).size();
-  for (int t = 1; t <= getMakespan(); ++t) {
-    if ((int)configs[t].size() != num_agents) {
-      warn("validation, invalid size");
+  // split timesteps into chunks
+  const int chunks_num = std::max(1, std::min(num_threads * 4, getMakespan()));
+  std::vector<int> t_invalid(chunks_num);
+  std::vector<std::string> msgs(chunks_num);
+  parallelFor(chunks_num, num_threads, [&](const int k) {
+    const int t_from = 1 + (long long)getMakespan() * k / chunks_num;
+    const int t_to = 1 + (long long)getMakespan() * (k + 1) / chunks_num;
+    t_invalid[k] = validateRange(t_from, t_to, msgs[k]);
+    if (t_invalid[k] == t_to) t_invalid[k] = -1;
+  });
+
+  // report the first error
+  for (int k = 0; k < chunks_num; ++k) {
+    if (t_invalid[k] != -1) {
+      warn("validation, " + msgs[k]);
       return false;
     }
+  }
+  return true;
+}
+
+int Plan::validateRange(const int t_from, const int t_to,
+                        std::string& msg) const
+{
+  constexpr int NIL = -1;
+  StampedArray<int> occupied_prev(nodes.size(), NIL);  // node id -> agent
+  StampedArray<int> occupied(nodes.size(), NIL);
+  // rows of t - 1 and t are restored alternately, own to this range
+  Cursor cursors[2];
+  Cursor& cursor_prev = cursors[(t_from - 1) & 1];
+  auto ids_prev = getNodeIds(t_from - 1, cursor_prev);
+  auto otts_prev = getPackedOrientations(t_from - 1, cursor_prev);
+  for (int i = 0; i < num_agents; ++i) {
+    if (ids_prev[i] != NIL) occupied_prev.set(ids_prev[i], i);
+  }
+
+  for (int t = t_from; t < t_to; ++t) {
+    auto ids = getNodeIds(t, cursors[t & 1]);
+    auto otts = getPackedOrientations(t, cursors[t & 1]);
+    occupied.clear();
     for (int i = 0; i < num_agents; ++i) {
-      Node* v_i_t = get(t, i);
-      Node* v_i_t_1 = get(t - 1, i);
-      Nodes cands = v_i_t_1->neighbor;
-      cands.push_back(v_i_t_1);
-      if (!inArray(v_i_t, cands)) {
-        warn("validation, invalid move at t=" + std::to_string(t));
-        return false;
+      const int a = ids_prev[i];
+      const int b = ids[i];
+      if (a == NIL || b == NIL) {
+        msg = "invalid move at t=" + std::to_string(t);
+        return t;
       }
-      // see conflicts
-      for (int j = i + 1; j < num_agents; ++j) {
-        Node* v_j_t = get(t, j);
-        Node* v_j_t_1 = get(t - 1, j);
-        if (v_i_t == v_j_t) {
-          warn("validation, vertex conflict at v=" + std::to_string(v_i_t->id) +
-               ", t=" + std::to_string(t));
-          return false;
+      // continuity
+      Node* v_from = nodes[a];
+      Node* v_to = nodes[b];
+      const auto dir = getRelativeOrientation(v_from, v_to);
+      if (a != b && !dir) {
+        msg = "invalid move at t=" + std::to_string(t);
+        return t;
+      }
+      // orientation
+      if (oriented) {
+        const auto o_from = unpack(otts_prev.begin(), i);
+        const auto o_to = unpack(otts.begin(), i);
+        if (a == b && ::getAngleDifference(o_from, o_to) == 180) {
+          msg = "invalid rotation at t=" + std::to_string(t);
+          return t;
         }
-        if (v_i_t == v_j_t_1 && v_i_t_1 == v_j_t) {
-          warn("validation, swap conflict");
-          return false;
+        if (a != b && (o_from != o_to || *dir != o_from)) {
+          msg = "move against orientation at t=" + std::to_string(t);
+          return t;
         }
       }
+      // vertex conflict
+      if (occupied[b] != NIL) {
+        msg = "vertex conflict at v=" + std::to_string(b) +
+              ", t=" + std::to_string(t);
+        return t;
+      }
+      occupied.set(b, i);
+      // swap conflict
+      const int j = occupied_prev[b];
+      if (a != b && j != NIL && j != i && ids[j] == a) {
+        msg = "swap conflict at t=" + std::to_string(t);
+        return t;
+      }
     }
+    std::swap(occupied_prev, occupied);
+    ids_prev = ids;
+    otts_prev = otts;
   }
-  return true;
+  return t_to;
 }
 
 int Plan::getMaxConstraintTime(const int id, Node* s, Node* g, Graph* G) const
 {
+  updateOccupancyIndex();
+  auto itr = occupancy_index.find(g->id);
+  if (itr == occupancy_index.end()) return 0;
   const int makespan = getMakespan();
   const int dist = G->pathDist(s, g);
-  const int num = configs[0].size();
-  for (int t = makespan - 1; t >= dist; --t) {
-    for (int i = 0; i < num; ++i) {
-      if (i != id && get(t, i) == g) return t;
-    }
+  const auto& R = itr->second;
+  for (auto r = R.rbegin(); r != R.rend(); ++r) {
+    if (r->agent == id) continue;
+    const int t = std::min(r->hi, makespan - 1);
+    if (t < r->lo) continue;
+    return (t >= dist) ? t : 0;
   }
   return 0;
 }
 
+void Plan::updateOccupancyIndex() const
+{
+  Cursor cursor;
+  for (int t = indexed_size; t < plan_size; ++t) {
+    auto ids = getNodeIds(t, cursor);
+    for (int i = 0; i < num_agents; ++i) {
+      auto& R = occupancy_index[ids[i]];
+      if (!R.empty() && R.back().agent == i && R.back().hi == t - 1) {
+        R.back().hi = t;
+      } else {
+        R.push_back({t, t, i});
+      }
+    }
+  }
+  indexed_size = plan_size;
+}
+
 int Plan::getMaxConstraintTime(const int id, MAPF_Instance* P) const
 {
   return getMaxConstraintTime(id, P->getStart(id), P->getGoal(id), P->getG());
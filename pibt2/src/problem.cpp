@@ -1,7 +1,7 @@
 #include "../include/problem.hpp"
 
+#include <cstring>
 #include <fstream>
-#include <regex>
 
 #include "../include/util.hpp"
 
@@ -48,48 +48,35 @@ MAPF_Instance::MAPF_Instance(const std::string& _instance)
     : Problem(_instance), instance_initialized(true)
 {
   // read instance file
-  std::ifstream file(instance);
-  if (!file) halt("file " + instance + " is not found.");
-
-  std::string line;
-  std::smatch results;
-  std::regex r_comment = std::regex(R"(#.+)");
-  std::regex r_map = std::regex(R"(map_file=(.+))");
-  std::regex r_agents = std::regex(R"(agents=(\d+))");
-  std::regex r_seed = std::regex(R"(seed=(\d+))");
-  std::regex r_random_problem = std::regex(R"(random_problem=(\d+))");
-  std::regex r_well_formed = std::regex(R"(well_formed=(\d+))");
-  std::regex r_max_timestep = std::regex(R"(max_timestep=(\d+))");
-  std::regex r_max_comp_time = std::regex(R"(max_comp_time=(\d+))");
-  std::regex r_sg = std::regex(R"((\d+),(\d+),(\d+),(\d+))");
+  MappedFile file(instance);
+  if (!file.isOpen()) halt("file " + instance + " is not found.");
 
+  std::string_view line, value;
+  int x;
   bool read_scen = true;
   bool well_formed = false;
-  while (getline(file, line)) {
-    // for CRLF coding
-    if (*(line.end() - 1) == 0x0d) line.pop_back();
+  while (file.getLine(line)) {
     // comment
-    if (std::regex_match(line, results, r_comment)) {
+    if (line.size() > 1 && line[0] == '#') {
       continue;
     }
     // read map
-    if (std::regex_match(line, results, r_map)) {
-      G = new Grid(results[1].str());
+    if (parseKey(line, "map_file", value)) {
+      G = new Grid(std::string(value));
       continue;
     }
     // set agent num
-    if (std::regex_match(line, results, r_agents)) {
-      num_agents = std::stoi(results[1].str());
+    if (parseKey(line, "agents", value) && parseDigits(value, num_agents)) {
       continue;
     }
     // set random seed
-    if (std::regex_match(line, results, r_seed)) {
-      MT = new std::mt19937(std::stoi(results[1].str()));
+    if (parseKey(line, "seed", value) && parseDigits(value, x)) {
+      MT = new std::mt19937(x);
       continue;
     }
     // skip reading initial/goal nodes
-    if (std::regex_match(line, results, r_random_problem)) {
-      if (std::stoi(results[1].str())) {
+    if (parseKey(line, "random_problem", value) && parseDigits(value, x)) {
+      if (x) {
         read_scen = false;
         config_s.clear();
         config_g.clear();
@@ -97,27 +84,25 @@ MAPF_Instance::MAPF_Instance(const std::string& _instance)
       continue;
     }
     //
-    if (std::regex_match(line, results, r_well_formed)) {
-      if (std::stoi(results[1].str())) well_formed = true;
+    if (parseKey(line, "well_formed", value) && parseDigits(value, x)) {
+      if (x) well_formed = true;
       continue;
     }
     // set max timestep
-    if (std::regex_match(line, results, r_max_timestep)) {
-      max_timestep = std::stoi(results[1].str());
+    if (parseKey(line, "max_timestep", value) &&
+        parseDigits(value, max_timestep)) {
       continue;
     }
     // set max computation time
-    if (std::regex_match(line, results, r_max_comp_time)) {
-      max_comp_time = std::stoi(results[1].str());
+    if (parseKey(line, "max_comp_time", value) &&
+        parseDigits(value, max_comp_time)) {
       continue;
     }
-    // read initial/goal nodes
-    if (std::regex_match(line, results, r_sg) && read_scen &&
-        (int)config_s.size() < num_agents) {
-      int x_s = std::stoi(results[1].str());
-      int y_s = std::stoi(results[2].str());
-      int x_g = std::stoi(results[3].str());
-      int y_g = std::stoi(results[4].str());
+    // read initial/goal nodes, x_s,y_s,x_g,y_g
+    int sg[4];
+    if (read_scen && (int)config_s.size() < num_agents &&
+        parseDigitsList(line, sg)) {
+      const int x_s = sg[0], y_s = sg[1], x_g = sg[2], y_g = sg[3];
       if (!G->existNode(x_s, y_s)) {
         halt("start node (" + std::to_string(x_s) + ", " + std::to_string(y_s) +
              ") does not exist, invalid scenario");
@@ -296,78 +281,66 @@ void MAPF_Instance::makeScenFile(const std::string& output_file)
 // -------------------------------------------
 // MAPD
 MAPD_Instance::MAPD_Instance(const std::string& _instance)
-    : Problem(_instance), current_timestep(-1), specify_pickup_deliv_locs(true)
+    : Problem(_instance),
+      task_frequency(0),
+      task_num(0),
+      current_timestep(-1),
+      specify_pickup_deliv_locs(true)
 {
   // read instance file
-  std::ifstream file(instance);
-  if (!file) halt("file " + instance + " is not found.");
-
-  std::string line;
-  std::smatch results;
-  std::regex r_comment = std::regex(R"(#.+)");
-  std::regex r_map = std::regex(R"(map_file=(.+))");
-  std::regex r_agents = std::regex(R"(agents=(\d+))");
-  std::regex r_seed = std::regex(R"(seed=(\d+))");
-  std::regex r_max_timestep = std::regex(R"(max_timestep=(\d+))");
-  std::regex r_max_comp_time = std::regex(R"(max_comp_time=(\d+))");
-  std::regex r_task_num = std::regex(R"(task_num=(\d+))");
-  std::regex r_task_frequency = std::regex(R"(task_frequency=(.+))");
-  std::regex r_specify_pikup_deliv_locs =
-      std::regex(R"(specify_pikup_deliv_locs=(\d+))");
-  std::regex r_sg = std::regex(R"((\d+),(\d+))");
-
-  while (getline(file, line)) {
-    // for CRLF coding
-    if (*(line.end() - 1) == 0x0d) line.pop_back();
+  MappedFile file(instance);
+  if (!file.isOpen()) halt("file " + instance + " is not found.");
+
+  std::string_view line, value;
+  int x;
+  while (file.getLine(line)) {
     // comment
-    if (std::regex_match(line, results, r_comment)) {
+    if (line.size() > 1 && line[0] == '#') {
       continue;
     }
     // read map
-    if (std::regex_match(line, results, r_map)) {
-      G = new Grid(results[1].str());
+    if (parseKey(line, "map_file", value)) {
+      G = new Grid(std::string(value));
       continue;
     }
     // set agent num
-    if (std::regex_match(line, results, r_agents)) {
-      num_agents = std::stoi(results[1].str());
+    if (parseKey(line, "agents", value) && parseDigits(value, num_agents)) {
       continue;
     }
     // set random seed
-    if (std::regex_match(line, results, r_seed)) {
-      MT = new std::mt19937(std::stoi(results[1].str()));
+    if (parseKey(line, "seed", value) && parseDigits(value, x)) {
+      MT = new std::mt19937(x);
       continue;
     }
     // set max timestep
-    if (std::regex_match(line, results, r_max_timestep)) {
-      max_timestep = std::stoi(results[1].str());
+    if (parseKey(line, "max_timestep", value) &&
+        parseDigits(value, max_timestep)) {
       continue;
     }
     // set max computation time
-    if (std::regex_match(line, results, r_max_comp_time)) {
-      max_comp_time = std::stoi(results[1].str());
+    if (parseKey(line, "max_comp_time", value) &&
+        parseDigits(value, max_comp_time)) {
       continue;
     }
     // set the number of tasks
-    if (std::regex_match(line, results, r_task_num)) {
-      task_num = std::stoi(results[1].str());
+    if (parseKey(line, "task_num", value) && parseDigits(value, task_num)) {
       continue;
     }
     // set task frequency
-    if (std::regex_match(line, results, r_task_frequency)) {
-      task_frequency = std::stof(results[1].str());
+    if (parseKey(line, "task_frequency", value)) {
+      task_frequency = std::stof(std::string(value));
       continue;
     }
     // set task frequency
-    if (std::regex_match(line, results, r_specify_pikup_deliv_locs)) {
-      specify_pickup_deliv_locs = (bool)std::stoi(results[1].str());
+    if (parseKey(line, "specify_pikup_deliv_locs", value) &&
+        parseDigits(value, x)) {
+      specify_pickup_deliv_locs = (bool)x;
       continue;
     }
-    // read initial nodes
-    if (std::regex_match(line, results, r_sg) &&
-        (int)config_s.size() < num_agents) {
-      int x_s = std::stoi(results[1].str());
-      int y_s = std::stoi(results[2].str());
+    // read initial nodes, x_s,y_s
+    int sg[2];
+    if ((int)config_s.size() < num_agents && parseDigitsList(line, sg)) {
+      const int x_s = sg[0], y_s = sg[1];
       if (!G->existNode(x_s, y_s)) {
         halt("start node (" + std::to_string(x_s) + ", " + std::to_string(y_s) +
              ") does not exist, invalid scenario");
@@ -440,43 +413,38 @@ void MAPD_Instance::setupSpetialNodes()
 
   // read instance file
 #ifdef _MAPDIR_
-  std::ifstream file(_MAPDIR_ + grid->getMapFileName() + ".pd");
+  MappedFile file(_MAPDIR_ + grid->getMapFileName() + ".pd");
 #else
-  std::ifstream file(grid->getMapFileName() + ".pd");
+  MappedFile file(grid->getMapFileName() + ".pd");
 #endif
-  if (!file) return;
+  if (!file.isOpen()) return;
 
-  std::string line, s;
-  std::smatch results;
-  std::regex r_obj = std::regex(R"([@T])");
-  std::regex r_pickup = std::regex(R"([psa])");  // pickup loc.
-  std::regex r_deliv = std::regex(R"([dsa])");   // delivery loc.
-  std::regex r_end = std::regex(R"([ea])");      // end loc.
+  auto isOneOf = [](const char c, const char* chars) {
+    return c != '\0' && std::strchr(chars, c) != nullptr;
+  };
 
   const int width = grid->getWidth();
 
+  std::string_view line;
   int y = 0;
-  while (getline(file, line)) {
-    // for CRLF coding
-    if (*(line.end() - 1) == 0x0d) line.pop_back();
-
+  while (file.getLine(line)) {
     if ((int)line.size() != width) halt("pd format is invalid");
 
     for (int x = 0; x < width; ++x) {
       if (!G->existNode(x, y)) continue;
 
       auto v = G->getNode(x, y);
-      s = line[x];
+      const char s = line[x];
       bool flg_endpoints = false;
-      if (std::regex_match(s, results, r_pickup)) {
+      if (isOneOf(s, "psa")) {  // pickup loc.
         LOCS_PICKUP.push_back(v);
         flg_endpoints = true;
       }
-      if (std::regex_match(s, results, r_deliv)) {
+      if (isOneOf(s, "dsa")) {  // delivery loc.
         LOCS_DELIVERY.push_back(v);
         flg_endpoints = true;
       }
-      if (std::regex_match(s, results, r_end)) {
+      if (isOneOf(s, "ea")) {  // end loc.
         LOCS_NONTASK_ENDPOINTS.push_back(v);
         flg_endpoints = true;
       }
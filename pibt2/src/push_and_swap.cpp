@@ -2,13 +2,17 @@
 
 #include <queue>
 
+#include "../include/trace.hpp"
+
 const std::string PushAndSwap::SOLVER_NAME = "PushAndSwap";
 
 PushAndSwap::PushAndSwap(MAPF_Instance* _P)
     : MAPF_Solver(_P),
       flg_compress(true),
       disable_dist_init(false),
-      emergency_stop(false)
+      emergency_stop(false),
+      tmp_occupied_now(G->getNodesSize(), NIL),
+      closed(G->getNodesSize(), false)
 {
   solver_name = PushAndSwap::SOLVER_NAME;
 }
@@ -18,8 +22,8 @@ void PushAndSwap::run()
   solution.add(P->getConfigStart());
 
   // occupancy
-  std::vector<int> occupied_now(G->getNodesSize(), NIL);
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[solution.last(i)->id] = i;
+  StampedArray<int> occupied_now(G->getNodesSize(), NIL);
+  for (int i = 0; i < P->getNum(); ++i) occupied_now.set(solution.last(i)->id, i);
 
   // pre-processing
   findNodesWithManyNeighbors();
@@ -79,7 +83,7 @@ void PushAndSwap::run()
 }
 
 bool PushAndSwap::push(Plan& plan, const int id, Nodes& U,
-                       std::vector<int>& occupied_now)
+                       StampedArray<int>& occupied_now)
 {
   if (plan.last(id) == P->getGoal(id)) return true;
 
@@ -105,7 +109,7 @@ bool PushAndSwap::push(Plan& plan, const int id, Nodes& U,
 }
 
 bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
-                       std::vector<int>& occupied_now)
+                       StampedArray<int>& occupied_now)
 {
   if (emergency_stop) return false;
 
@@ -133,7 +137,11 @@ bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
     swap_verticies.erase(swap_verticies.begin());
     auto p = G->getPath(plan.last(r), v, false);  // no cache
     tmp_plan.clear();
-    auto tmp_occupied_now = occupied_now;
+    // same as occupied_now, without copying the whole array
+    tmp_occupied_now.clear();
+    for (int i = 0; i < P->getNum(); ++i) {
+      tmp_occupied_now.set(plan.last(i)->id, i);
+    }
     tmp_plan.add(plan.last());
     if (v == plan.last(r) || multiPush(tmp_plan, r, s, p, tmp_occupied_now)) {
       if (clear(tmp_plan, v, r, s, tmp_occupied_now)) succcess = true;
@@ -141,12 +149,11 @@ bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
   }
   if (!succcess) return false;
 
-  // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = NIL;
   // update plan
   plan += tmp_plan;
   // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = i;
+  occupied_now.clear();
+  for (int i = 0; i < P->getNum(); ++i) occupied_now.set(plan.last(i)->id, i);
 
   executeSwap(plan, r, s, occupied_now);
   Plan reversed_tmp_plan;
@@ -160,22 +167,22 @@ bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
       reversed_tmp_plan.add(c);
     }
   }
-  // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = NIL;
   // update plan
   plan += reversed_tmp_plan;
   // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = i;
+  occupied_now.clear();
+  for (int i = 0; i < P->getNum(); ++i) occupied_now.set(plan.last(i)->id, i);
 
   // validation
+#ifndef NDEBUG
   const Config c_after = plan.last();
   for (int i = 0; i < P->getNum(); ++i) {
-    if ((i == s && c_after[s] != c_before[r]) ||
-        (i == r && c_after[r] != c_before[s]) ||
-        (i != s && i != r && c_after[i] != c_before[i])) {
-      halt("invalid swap operation");
-    }
+    TRACE_ASSERT(!((i == s && c_after[s] != c_before[r]) ||
+                   (i == r && c_after[r] != c_before[s]) ||
+                   (i != s && i != r && c_after[i] != c_before[i])),
+                 "invalid swap operation");
   }
+#endif
   info("   ", "agent-" + std::to_string(r) + ", " + std::to_string(s) +
                   " swap locations " + std::to_string(c_before[r]->id) + ", " +
                   std::to_string(c_before[s]->id));
@@ -186,7 +193,7 @@ bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
 }
 
 bool PushAndSwap::resolve(Plan& plan, const int r, const int s, Nodes& U,
-                          std::vector<int>& occupied_now)
+                          StampedArray<int>& occupied_now)
 {
   if (emergency_stop) return false;
 
@@ -242,7 +249,7 @@ bool PushAndSwap::resolve(Plan& plan, const int r, const int s, Nodes& U,
 }
 
 bool PushAndSwap::multiPush(Plan& plan, const int r, const int s, const Path& p,
-                            std::vector<int>& occupied_now)
+                            StampedArray<int>& occupied_now)
 {
   if (emergency_stop) return false;
 
@@ -284,16 +291,18 @@ bool PushAndSwap::multiPush(Plan& plan, const int r, const int s, const Path& p,
   return true;
 }
 
-void PushAndSwap::checkConsistency(Plan& plan, std::vector<int>& occupied_now)
+void PushAndSwap::checkConsistency(Plan& plan, StampedArray<int>& occupied_now)
 {
+#ifndef NDEBUG
   auto c = plan.last();
   for (int i = 0; i < P->getNum(); ++i) {
-    if (occupied_now[c[i]->id] != i) halt("check consistency");
+    TRACE_ASSERT(occupied_now[c[i]->id] == i, "check consistency, agent", i);
   }
+#endif
 }
 
 bool PushAndSwap::clear(Plan& plan, Node* v, const int r, const int s,
-                        std::vector<int>& occupied_now)
+                        StampedArray<int>& occupied_now)
 {
   if (emergency_stop) return false;
 
@@ -362,7 +371,7 @@ bool PushAndSwap::clear(Plan& plan, Node* v, const int r, const int s,
 }
 
 void PushAndSwap::executeSwap(Plan& plan, const int r, const int s,
-                              std::vector<int>& occupied_now)
+                              StampedArray<int>& occupied_now)
 {
   // identify empty loc
   Node* empty1 = nullptr;
@@ -392,7 +401,7 @@ void PushAndSwap::executeSwap(Plan& plan, const int r, const int s,
 }
 
 void PushAndSwap::updatePlan(const int id, Node* next_node, Plan& plan,
-                             std::vector<int>& occupied_now)
+                             StampedArray<int>& occupied_now)
 {
   // error check
   if (occupied_now[plan.last(id)->id] != id) halt("invalid update");
@@ -405,8 +414,8 @@ void PushAndSwap::updatePlan(const int id, Node* next_node, Plan& plan,
   }
 
   // update occupancy
-  occupied_now[plan.last(id)->id] = NIL;
-  occupied_now[next_node->id] = id;
+  occupied_now.set(plan.last(id)->id, NIL);
+  occupied_now.set(next_node->id, id);
   // update plan
   Config c = plan.last();
   c[id] = next_node;
@@ -414,7 +423,7 @@ void PushAndSwap::updatePlan(const int id, Node* next_node, Plan& plan,
 }
 
 bool PushAndSwap::pushTowardEmptyNode(Node* v_current, Plan& plan,
-                                      std::vector<int>& occupied_now,
+                                      StampedArray<int>& occupied_now,
                                       const Nodes& obs)
 {
   Node* v_empty = getNearestEmptyNode(v_current, occupied_now, obs);
@@ -430,7 +439,7 @@ bool PushAndSwap::pushTowardEmptyNode(Node* v_current, Plan& plan,
 }
 
 Path PushAndSwap::getShortestPath(const int id, Node* s,
-                                  std::vector<int>& occupied_now)
+                                  StampedArray<int>& occupied_now)
 {
   Nodes p = {s};
   Node* g = P->getGoal(id);
@@ -453,20 +462,20 @@ Path PushAndSwap::getShortestPath(const int id, Node* s,
   return p;
 }
 
-Node* PushAndSwap::getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
+Node* PushAndSwap::getNearestEmptyNode(Node* v, StampedArray<int>& occupied_now,
                                        const Nodes& obs)
 {
   const int id = occupied_now[v->id];
   Node* v_empty = nullptr;
   std::queue<int> OPEN;
-  std::vector<bool> CLOSE(G->getNodesSize(), false);
-  for (auto v : obs) CLOSE[v->id] = true;
+  closed.clear();
+  for (auto v : obs) closed.set(v->id, true);
   OPEN.push(v->id);
   while (!OPEN.empty()) {
     int i = OPEN.front();
     OPEN.pop();
-    if (CLOSE[i]) continue;
-    CLOSE[i] = true;
+    if (closed[i]) continue;
+    closed.set(i, true);
     Node* u = G->getNode(i);
     if (occupied_now[i] == NIL) {
       v_empty = u;
@@ -474,7 +483,7 @@ Node* PushAndSwap::getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
     }
     Nodes C;
     for (auto w : u->neighbor) {
-      if (CLOSE[w->id]) continue;
+      if (closed[w->id]) continue;
       C.push_back(w);
     }
     std::sort(C.begin(), C.end(), [&](Node* a, Node* b) {
@@ -488,10 +497,8 @@ Node* PushAndSwap::getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
 
 void PushAndSwap::findNodesWithManyNeighbors()
 {
-  nodes_with_many_neighbors.clear();
-  auto V = G->getV();
-  for (auto v : V)
-    if (v->getDegree() >= 3) nodes_with_many_neighbors.push_back(v);
+  // junctions of the corridor decomposition
+  nodes_with_many_neighbors = G->getJunctions();
 }
 
 /*
@@ -0,0 +1,156 @@
+#include "../include/reservation_table.hpp"
+
+ReservationTable::ReservationTable(const int nodes_size)
+    : table(nodes_size), used(nodes_size, false)
+{
+}
+
+ReservationTable::Reservations::const_iterator ReservationTable::lowerBound(
+    const Reservations& R, const int t)
+{
+  // intervals are disjoint, hence sorted also by hi
+  return std::lower_bound(
+      R.begin(), R.end(), t,
+      [](const Reservation& r, const int _t) { return r.hi < _t; });
+}
+
+void ReservationTable::insert(Node* const v, const int lo, const int hi,
+                              const int agent)
+{
+  auto& R = table[v->id];
+  if (!used[v->id]) {
+    used[v->id] = true;
+    used_nodes.push_back(v);
+  }
+
+  // cut off overlapping parts of others, merge adjacent ones of the agent
+  int new_lo = lo, new_hi = hi;
+  auto first = R.begin() + (lowerBound(R, lo - 1) - R.begin());
+  auto last = first;
+  Reservations rest;  // remaining parts of overlapping reservations
+  for (; last != R.end() && (hi == INF || last->lo <= hi + 1); ++last) {
+    if (last->agent == agent) {
+      new_lo = std::min(new_lo, last->lo);
+      new_hi = (last->hi == INF) ? INF : std::max(new_hi, last->hi);
+      continue;
+    }
+    if (last->lo < lo) rest.push_back({last->lo, lo - 1, last->agent});
+    if (hi != INF && (last->hi == INF || last->hi > hi)) {
+      rest.push_back({hi + 1, last->hi, last->agent});
+    }
+  }
+  rest.push_back({new_lo, new_hi, agent});
+  std::sort(rest.begin(), rest.end(),
+            [](const Reservation& a, const Reservation& b) {
+              return a.lo < b.lo;
+            });
+  const auto k = first - R.begin();
+  R.erase(first, last);
+  R.insert(R.begin() + k, rest.begin(), rest.end());
+}
+
+void ReservationTable::remove(Node* const v, const int lo, const int hi,
+                              const int agent)
+{
+  auto& R = table[v->id];
+  auto first = R.begin() + (lowerBound(R, lo) - R.begin());
+  auto last = first;
+  Reservations rest;
+  for (; last != R.end() && (hi == INF || last->lo <= hi); ++last) {
+    if (last->agent != agent) {
+      rest.push_back(*last);
+      continue;
+    }
+    if (last->lo < lo) rest.push_back({last->lo, lo - 1, agent});
+    if (hi != INF && (last->hi == INF || last->hi > hi)) {
+      rest.push_back({hi + 1, last->hi, agent});
+    }
+  }
+  const auto k = first - R.begin();
+  R.erase(first, last);
+  R.insert(R.begin() + k, rest.begin(), rest.end());
+}
+
+void ReservationTable::insert(const Path& path, const int agent,
+                              const int t_offset, const bool stay_forever)
+{
+  const int path_size = path.size();
+  for (int t = 0; t < path_size;) {
+    int t_next = t + 1;  // next move
+    while (t_next < path_size && path[t_next] == path[t]) ++t_next;
+    const int hi =
+        (stay_forever && t_next == path_size) ? INF : t_offset + t_next - 1;
+    insert(path[t], t_offset + t, hi, agent);
+    t = t_next;
+  }
+}
+
+void ReservationTable::remove(const Path& path, const int agent,
+                              const int t_offset, const bool stay_forever)
+{
+  const int path_size = path.size();
+  for (int t = 0; t < path_size;) {
+    int t_next = t + 1;
+    while (t_next < path_size && path[t_next] == path[t]) ++t_next;
+    const int hi =
+        (stay_forever && t_next == path_size) ? INF : t_offset + t_next - 1;
+    remove(path[t], t_offset + t, hi, agent);
+    t = t_next;
+  }
+}
+
+void ReservationTable::clear()
+{
+  for (auto v : used_nodes) {
+    table[v->id].clear();
+    used[v->id] = false;
+  }
+  used_nodes.clear();
+}
+
+int ReservationTable::get(Node* const v, const int t) const
+{
+  const auto& R = table[v->id];
+  auto itr = lowerBound(R, t);
+  if (itr == R.end() || itr->lo > t) return NIL;
+  return itr->agent;
+}
+
+int ReservationTable::getLatestTime(Node* const v, const int agent,
+                                    const int t_max) const
+{
+  const auto& R = table[v->id];
+  for (auto r = R.rbegin(); r != R.rend(); ++r) {
+    if (r->agent == agent || r->lo > t_max) continue;
+    return std::min(r->hi, t_max);
+  }
+  return NIL;
+}
+
+bool ReservationTable::isSwapConflict(Node* const from, Node* const to,
+                                      const int t) const
+{
+  const int agent = get(from, t);
+  return agent != NIL && get(to, t - 1) == agent;
+}
+
+void ReservationTable::getSafeIntervals(Node* const v, const int t_start,
+                                        SIPP::Intervals& out) const
+{
+  const auto& R = table[v->id];
+  int lo = 0;
+  for (auto itr = lowerBound(R, t_start + 1); itr != R.end(); ++itr) {
+    const int r_lo = std::max(itr->lo, t_start + 1) - t_start;
+    if (lo < r_lo) out.push_back({lo, r_lo - 1});
+    if (itr->hi == INF) return;
+    lo = itr->hi - t_start + 1;
+  }
+  out.push_back({lo, INF});
+}
+
+int ReservationTable::getReservationsSize() const
+{
+  int cnt = 0;
+  for (auto v : used_nodes) cnt += table[v->id].size();
+  return cnt;
+}
@@ -0,0 +1,384 @@
+#include "../include/result_log.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+
+constexpr char ResultLog::MAGIC[8];
+
+static std::uint64_t getVarint(const std::uint8_t*& p)
+{
+  std::uint64_t x = 0;
+  for (int shift = 0;; shift += 7) {
+    const std::uint8_t b = *p++;
+    x |= (std::uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) return x;
+  }
+}
+
+static int unpackOrientation(const std::uint8_t* otts, const int i)
+{
+  return (otts == nullptr) ? 0 : (otts[i >> 2] >> ((i & 3) << 1)) & 3;
+}
+
+// -------------------------------
+// writer
+// -------------------------------
+ResultLogWriter::ResultLogWriter(const std::string& _file, const Kind _kind,
+                                 const int _num_agents, const int _width,
+                                 const int _keyframe_interval)
+    : file(_file),
+      kind(_kind),
+      num_agents(_num_agents),
+      width(_width),
+      keyframe_interval(std::max(1, _keyframe_interval)),
+      out(_file, std::ios::binary | std::ios::trunc),
+      closed(false),
+      timesteps(0),
+      written(sizeof(Header)),
+      finishing(false)
+{
+  if (!out) halt("failed to open " + file);
+
+  Header header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.kind = kind;
+  header.agents = num_agents;
+  header.width = width;
+  header.keyframe_interval = keyframe_interval;
+  header.reserved = 0;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+  prev.node_ids.assign(num_agents, 0);
+  prev.otts.assign(num_agents, Orientation::X_PLUS);
+  if (kind == Kind::MAPD) {
+    prev.target_ids.assign(num_agents, 0);
+    prev.task_ids.assign(num_agents, 0);
+  }
+  buf.reserve(CHUNK_SIZE);
+  worker = std::thread(&ResultLogWriter::writeChunks, this);
+}
+
+ResultLogWriter::~ResultLogWriter()
+{
+  if (!closed) close("");
+}
+
+void ResultLogWriter::append(const int* node_ids,
+                             const std::uint8_t* packed_otts,
+                             const int* target_ids, const int* task_ids)
+{
+  if (closed) halt("append after close");
+  const bool mapd = (kind == Kind::MAPD);
+  if (mapd && (target_ids == nullptr || task_ids == nullptr)) {
+    halt("targets and tasks are required for MAPD");
+  }
+  offsets.push_back(written + buf.size());
+
+  if (timesteps % keyframe_interval == 0) {
+    // keyframe, all agents
+    for (int i = 0; i < num_agents; ++i) putVarint(node_ids[i]);
+    for (int k = 0; k < (num_agents + 3) / 4; ++k) {
+      buf.push_back((packed_otts == nullptr) ? 0 : packed_otts[k]);
+    }
+    if (mapd) {
+      for (int i = 0; i < num_agents; ++i) putVarint(target_ids[i]);
+      for (int i = 0; i < num_agents; ++i) putVarint(task_ids[i] + 1);
+    }
+
+  } else {
+    // agents that changed, {gap from the previous one, code, [values]}
+    auto getCode = [&](const int i) -> std::uint8_t {
+      const int d = node_ids[i] - prev.node_ids[i];
+      std::uint8_t move = JUMP;
+      if (d == 0) {
+        move = STAY;
+      } else if (d == 1) {
+        move = X_PLUS;
+      } else if (d == width) {
+        move = Y_PLUS;
+      } else if (d == -1) {
+        move = X_MINUS;
+      } else if (d == -width) {
+        move = Y_MINUS;
+      }
+      std::uint8_t code = move << 2 | unpackOrientation(packed_otts, i);
+      if (mapd && target_ids[i] != prev.target_ids[i]) code |= TARGET_CHANGED;
+      if (mapd && task_ids[i] != prev.task_ids[i]) code |= TASK_CHANGED;
+      return code;
+    };
+    auto isChanged = [&](const int i, const std::uint8_t code) {
+      return code != (STAY << 2 | toIndex(prev.otts[i]));
+    };
+
+    int changed = 0;
+    for (int i = 0; i < num_agents; ++i) {
+      if (isChanged(i, getCode(i))) ++changed;
+    }
+    putVarint(changed);
+    for (int i = 0, last = -1; i < num_agents; ++i) {
+      const auto code = getCode(i);
+      if (!isChanged(i, code)) continue;
+      putVarint(i - last - 1);
+      last = i;
+      buf.push_back(code);
+      if (((code >> 2) & 7) == JUMP) putVarint(node_ids[i]);
+      if (code & TARGET_CHANGED) putVarint(target_ids[i]);
+      if (code & TASK_CHANGED) putVarint(task_ids[i] + 1);
+    }
+  }
+
+  for (int i = 0; i < num_agents; ++i) {
+    prev.node_ids[i] = node_ids[i];
+    prev.otts[i] = static_cast<Orientation>(unpackOrientation(packed_otts, i));
+    if (mapd) {
+      prev.target_ids[i] = target_ids[i];
+      prev.task_ids[i] = task_ids[i];
+    }
+  }
+  ++timesteps;
+  if (buf.size() >= CHUNK_SIZE) flush();
+}
+
+void ResultLogWriter::putVarint(std::uint64_t x)
+{
+  while (x >= 0x80) {
+    buf.push_back((x & 0x7f) | 0x80);
+    x >>= 7;
+  }
+  buf.push_back(x);
+}
+
+// pass the current chunk to the background thread,
+// wait when it lags behind to bound the memory
+void ResultLogWriter::flush()
+{
+  if (buf.empty()) return;
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]() { return chunks.size() < MAX_CHUNKS; });
+    written += buf.size();
+    chunks.push_back(std::move(buf));
+  }
+  cv.notify_all();
+  buf = std::vector<std::uint8_t>();
+  buf.reserve(CHUNK_SIZE);
+}
+
+void ResultLogWriter::writeChunks()
+{
+  while (true) {
+    std::vector<std::uint8_t> chunk;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [&]() { return finishing || !chunks.empty(); });
+      if (chunks.empty()) return;
+      chunk = std::move(chunks.front());
+      chunks.pop_front();
+    }
+    cv.notify_all();
+    out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+  }
+}
+
+void ResultLogWriter::close(const std::string& preamble)
+{
+  if (closed) return;
+  closed = true;
+  flush();
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    finishing = true;
+  }
+  cv.notify_all();
+  worker.join();
+
+  Footer footer;
+  footer.timesteps = timesteps;
+  footer.index_offset = written;
+  offsets.push_back(written);
+  out.write(reinterpret_cast<const char*>(offsets.data()),
+            offsets.size() * sizeof(std::uint64_t));
+  footer.preamble_offset =
+      footer.index_offset + offsets.size() * sizeof(std::uint64_t);
+  out.write(preamble.data(), preamble.size());
+  std::memcpy(footer.magic, MAGIC, sizeof(MAGIC));
+  out.write(reinterpret_cast<const char*>(&footer), sizeof(Footer));
+  out.close();
+  if (!out) halt("failed to write " + file);
+}
+
+void ResultLogWriter::halt(const std::string& msg) const
+{
+  std::cout << "error@ResultLogWriter: " << msg << std::endl;
+  std::exit(1);
+}
+
+// -------------------------------
+// reader
+// -------------------------------
+ResultLogReader::ResultLogReader(const std::string& _file)
+    : file(_file), data(nullptr), data_size(0), timesteps(0)
+{
+  const int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) halt("failed to open " + file);
+  struct stat st;
+  if (fstat(fd, &st) == 0 &&
+      (std::size_t)st.st_size >= sizeof(Header) + sizeof(Footer)) {
+    data_size = st.st_size;
+    data = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) data = nullptr;
+  }
+  ::close(fd);
+  if (data == nullptr) halt("failed to read " + file);
+  bytes = static_cast<const std::uint8_t*>(data);
+
+  // validate
+  header = static_cast<const Header*>(data);
+  Footer footer;
+  std::memcpy(&footer, bytes + data_size - sizeof(Footer), sizeof(Footer));
+  const std::uint64_t preamble_end = data_size - sizeof(Footer);
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      std::memcmp(footer.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    halt("not a result log, " + file);
+  }
+  if (header->version != VERSION) halt("unsupported version, " + file);
+  if (header->keyframe_interval == 0 || footer.index_offset < sizeof(Header) ||
+      footer.preamble_offset != footer.index_offset + (footer.timesteps + 1) *
+                                                          sizeof(std::uint64_t) ||
+      footer.preamble_offset > preamble_end) {
+    halt("broken result log, " + file);
+  }
+  timesteps = footer.timesteps;
+  index = bytes + footer.index_offset;
+  preamble = std::string(reinterpret_cast<const char*>(bytes) +
+                             footer.preamble_offset,
+                         preamble_end - footer.preamble_offset);
+}
+
+ResultLogReader::~ResultLogReader()
+{
+  if (data != nullptr) munmap(data, data_size);
+}
+
+// the index is not aligned
+std::uint64_t ResultLogReader::getOffset(const int t) const
+{
+  std::uint64_t offset;
+  std::memcpy(&offset, index + t * sizeof(std::uint64_t), sizeof(offset));
+  return offset;
+}
+
+void ResultLogReader::decode(const std::uint8_t*& p, const bool keyframe,
+                             Row& row) const
+{
+  const int num_agents = header->agents;
+  const int width = header->width;
+  const bool mapd = (header->kind == Kind::MAPD);
+
+  if (keyframe) {
+    for (int i = 0; i < num_agents; ++i) row.node_ids[i] = getVarint(p);
+    for (int i = 0; i < num_agents; ++i) {
+      row.otts[i] = static_cast<Orientation>(unpackOrientation(p, i));
+    }
+    p += (num_agents + 3) / 4;
+    if (mapd) {
+      for (int i = 0; i < num_agents; ++i) row.target_ids[i] = getVarint(p);
+      for (int i = 0; i < num_agents; ++i) {
+        row.task_ids[i] = (int)getVarint(p) - 1;
+      }
+    }
+    return;
+  }
+
+  int changed = getVarint(p);
+  for (int i = -1; changed > 0; --changed) {
+    i += getVarint(p) + 1;
+    const std::uint8_t code = *p++;
+    row.otts[i] = static_cast<Orientation>(code & 3);
+    switch ((code >> 2) & 7) {
+      case X_PLUS:
+        row.node_ids[i] += 1;
+        break;
+      case Y_PLUS:
+        row.node_ids[i] += width;
+        break;
+      case X_MINUS:
+        row.node_ids[i] -= 1;
+        break;
+      case Y_MINUS:
+        row.node_ids[i] -= width;
+        break;
+      case JUMP:
+        row.node_ids[i] = getVarint(p);
+        break;
+      default:
+        break;
+    }
+    if (code & TARGET_CHANGED) row.target_ids[i] = getVarint(p);
+    if (code & TASK_CHANGED) row.task_ids[i] = (int)getVarint(p) - 1;
+  }
+}
+
+void ResultLogReader::resize(Row& row) const
+{
+  const int num_agents = header->agents;
+  const int mapd_size = (header->kind == Kind::MAPD) ? num_agents : 0;
+  row.node_ids.resize(num_agents);
+  row.otts.resize(num_agents);
+  row.target_ids.resize(mapd_size);
+  row.task_ids.resize(mapd_size);
+}
+
+void ResultLogReader::read(const int t, Row& row) const
+{
+  if (t < 0 || t >= timesteps) {
+    halt("timestep " + std::to_string(t) + " is out of range");
+  }
+  resize(row);
+  const int keyframe = t - t % header->keyframe_interval;
+  const std::uint8_t* p = bytes + getOffset(keyframe);
+  for (int s = keyframe; s <= t; ++s) decode(p, s == keyframe, row);
+}
+
+void ResultLogReader::toText(std::ostream& os) const
+{
+  os << preamble;
+  const int width = header->width;
+  read(0, timesteps, [&](const int t, const Row& row) {
+    os << t << ":";
+    for (int i = 0; i < (int)header->agents; ++i) {
+      const int x = row.node_ids[i] % width;
+      const int y = row.node_ids[i] / width;
+      if (header->kind == Kind::MAPD) {
+        os << "(" << x << "," << y << ")->(" << row.target_ids[i] % width
+           << "," << row.target_ids[i] / width << "):" << row.task_ids[i]
+           << ",";
+      } else {
+        os << "(" << x << "," << y << "," << orientationToString(row.otts[i])
+           << "),";
+      }
+    }
+    os << "\n";
+  });
+}
+
+bool ResultLogReader::isBinary(const std::string& file)
+{
+  char magic[sizeof(MAGIC)];
+  std::ifstream in(file, std::ios::binary);
+  return in.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void ResultLogReader::halt(const std::string& msg) const
+{
+  std::cout << "error@ResultLogReader: " << msg << std::endl;
+  if (data != nullptr) munmap(data, data_size);
+  std::exit(1);
+}
@@ -0,0 +1,34 @@
+#include "../include/sipp.hpp"
+
+SIPP::SIPP() : search_cnt(0) {}
+
+void SIPP::reset(const int nodes_size)
+{
+  arena.clear();
+  OPEN.clear();
+  intervals.clear();
+  earliest.clear();
+  if ((int)stamp.size() != nodes_size) {
+    stamp.assign(nodes_size, -1);
+    first.resize(nodes_size);
+    last.resize(nodes_size);
+  }
+  ++search_cnt;
+}
+
+void SIPP::block(Intervals& I, const std::size_t from, const int lo,
+                 const int hi)
+{
+  Intervals rest;
+  for (auto k = from; k < I.size(); ++k) {
+    const auto& J = I[k];
+    if (J.hi < lo || (hi != INF && J.lo > hi)) {
+      rest.push_back(J);
+      continue;
+    }
+    if (J.lo < lo) rest.push_back({J.lo, lo - 1});
+    if (hi != INF && J.hi > hi) rest.push_back({hi + 1, J.hi});
+  }
+  I.resize(from);
+  I.insert(I.end(), rest.begin(), rest.end());
+}
@@ -1,9 +1,13 @@
 #include "../include/solver.hpp"
 
 
+#include "../include/trace.hpp"
+
 #include <optional>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <sstream>
 
 MinimumSolver::MinimumSolver(Problem* _P)
     : solver_name(""),
@@ -14,7 +18,9 @@ MinimumSolver::MinimumSolver(Problem* _P)
       solved(false),
       comp_time(0),
       verbose(false),
-      log_short(false)
+      log_short(false),
+      log_format(LogFormat::TEXT),
+      log_rows(0)
 {
 }
 
@@ -77,10 +83,14 @@ MAPF_Solver::MAPF_Solver(MAPF_Instance* _P)
       P(_P),
       LB_soc(0),
       LB_makespan(0),
-      distance_table(_P->getNum(),
-                     std::vector<int>(G->getNodesSize(), max_timestep)),
-      basic_distance_table(_P->getNum(), std::vector<int>(G->getNodesSize(), max_timestep)),  // 新增
-      distance_table_p(nullptr)
+      distance_table_p(nullptr),
+      num_threads(DEFAULT_NUM_THREADS),
+      lazy_distance(false),
+      distance_memory_budget(0),
+      use_distance_cache(false),
+      preprocessing_comp_time(0),
+      PATH_TABLE(G->getNodesSize()),
+      use_sipp(false)
 {
 }
 
@@ -91,13 +101,29 @@ MAPF_Solver::~MAPF_Solver() {}
 // -------------------------------
 void MAPF_Solver::exec()
 {
+  openLog();
+
   // create distance table
   if (distance_table_p == nullptr) {
-    info("  pre-processing, create distance table by BFS");
+    info("  pre-processing, create distance table by BFS",
+         lazy_distance ? "(lazy)" : "");
     //createDistanceTable();
     createDistanceTableWithOrientation();
     preprocessing_comp_time = getSolverElapsedTime();
-    info("  done, elapsed: ", preprocessing_comp_time);
+    TRACE_EVENT("distance table, elapsed:", preprocessing_comp_time,
+                "rows:", distance_table->getRowsSize());
+    info("  done, elapsed: ", preprocessing_comp_time,
+         ", rows: ", distance_table->getRowsSize(),
+         ", memory (byte): ", distance_table->getMemoryUsage());
+  }
+
+  // agents with the same goal share one row
+  distance_rows.resize(P->getNum());
+  for (int i = 0; i < P->getNum(); ++i) {
+    distance_rows[i] = getDistanceTable()->getRow(P->getGoal(i));
+    if (distance_rows[i] == DistanceTable::NIL) {
+      halt("goal of agent-" + std::to_string(i) + " is not in distance table");
+    }
   }
 
   run();
@@ -112,7 +138,7 @@ void MAPF_Solver::computeLowerBounds()
   LB_makespan = 0;
 
   for (int i = 0; i < P->getNum(); ++i) {
-    int d = pathDist(i);
+    int d = pathDistAnyDir(i, P->getStart(i));
     LB_soc += d;
     if (d > LB_makespan) LB_makespan = d;
   }
@@ -208,6 +234,10 @@ void MinimumSolver::printHelpWithoutOption(const std::string& solver_name)
 // -------------------------------
 void MAPF_Solver::makeLog(const std::string& logfile)
 {
+  if (log_format == LogFormat::BINARY) {
+    makeLogBinary(logfile);
+    return;
+  }
   std::ofstream log;
   log.open(logfile, std::ios::out);
   makeLogBasicInfo(log);
@@ -215,7 +245,7 @@ void MAPF_Solver::makeLog(const std::string& logfile)
   log.close();
 }
 
-void MAPF_Solver::makeLogBasicInfo(std::ofstream& log)
+void MAPF_Solver::makeLogBasicInfo(std::ostream& log)
 {
   Grid* grid = reinterpret_cast<Grid*>(P->getG());
   log << "instance=" << P->getInstanceFileName() << "\n";
@@ -231,9 +261,8 @@ void MAPF_Solver::makeLogBasicInfo(std::ofstream& log)
   log << "preprocessing_comp_time=" << preprocessing_comp_time << "\n";
 }
 
-void MAPF_Solver::makeLogSolution(std::ofstream& log)
+void MAPF_Solver::makeLogInstance(std::ostream& log)
 {
-  if (log_short) return;
   log << "starts=";
   for (int i = 0; i < P->getNum(); ++i) {
     Node* v = P->getStart(i);
@@ -245,39 +274,78 @@ void MAPF_Solver::makeLogSolution(std::ofstream& log)
     log << "(" << v->pos.x << "," << v->pos.y << "),";
   }
   log << "\n";
+}
+
+void MAPF_Solver::makeLogSolution(std::ostream& log)
+{
+  if (log_short) return;
+  makeLogInstance(log);
   log << "solution=\n";
   for (int t = 0; t <= solution.getMakespan(); ++t) {
     log << t << ":";
     auto c = solution.get(t);
-    auto orients = solution.getOrientations(t); //测试
-    //测试
+    auto orients = solution.getOrientations(t);
     for (int i = 0; i < P->getNum(); ++i) {
       Node* v = c[i];
-      Orientation orient = orients[i];
-      std::string orient_str;
-      switch (orient) {
-          case Orientation::X_PLUS:  orient_str = "X_PLUS"; break;
-          case Orientation::X_MINUS: orient_str = "X_MINUS"; break;
-          case Orientation::Y_PLUS:  orient_str = "Y_PLUS"; break;
-          case Orientation::Y_MINUS: orient_str = "Y_MINUS"; break;
-      }
-            
-      log << "(" << v->pos.x << "," << v->pos.y << "," << orient_str << "),";
-
+      log << "(" << v->pos.x << "," << v->pos.y << ","
+          << orientationToString(orients[i]) << "),";
     }
     log << "\n";
   }
 }
 
+void MAPF_Solver::makeLogBinary(const std::string& logfile)
+{
+  if (log_writer == nullptr || logfile != log_file) {
+    // not written while solving
+    Grid* grid = reinterpret_cast<Grid*>(P->getG());
+    log_writer = std::make_unique<ResultLogWriter>(
+        logfile, ResultLog::Kind::MAPF, P->getNum(), grid->getWidth());
+    log_rows = 0;
+  }
+  std::ostringstream preamble;
+  makeLogBasicInfo(preamble);
+  if (!log_short) {
+    makeLogInstance(preamble);
+    preamble << "solution=\n";
+    appendLog();
+  }
+  log_writer->close(preamble.str());
+  log_writer.reset();
+}
+
+void MAPF_Solver::openLog()
+{
+  log_writer.reset();
+  log_rows = 0;
+  if (log_format != LogFormat::BINARY || log_file.empty() || log_short) return;
+  Grid* grid = reinterpret_cast<Grid*>(P->getG());
+  log_writer = std::make_unique<ResultLogWriter>(
+      log_file, ResultLog::Kind::MAPF, P->getNum(), grid->getWidth());
+}
+
+void MAPF_Solver::appendLog()
+{
+  if (log_writer == nullptr) return;
+  if (log_rows > solution.size()) halt("solution was rewritten after logged");
+  Plan::Cursor cursor;
+  for (; log_rows < solution.size(); ++log_rows) {
+    log_writer->append(solution.getNodeIds(log_rows, cursor).ptr,
+                       solution.getPackedOrientations(log_rows, cursor).ptr);
+  }
+}
+
 // -------------------------------
 // distance
 // -------------------------------
 int MAPF_Solver::pathDist(const int i, Node* const s) const
 {
-  if (distance_table_p != nullptr) {
-    return distance_table_p->operator[](i)[s->id];
-  }
-  return distance_table[i][s->id];
+  return pathDistAnyDir(i, s);
+}
+
+int MAPF_Solver::pathDistAnyDir(const int i, Node* const s) const
+{
+  return getDistanceTable()->get(distance_rows[i], s);
 }
 
 int MAPF_Solver::pathDist(const int i) const
@@ -288,15 +356,13 @@ int MAPF_Solver::pathDist(const int i) const
 // 测试：添加重载函数，支持带方向的距离计算
 int MAPF_Solver::pathDist(const int i, Node* const s, Orientation dir) const
 {
-    int state_idx = s->id * 4 + static_cast<int>(dir);
-    if (distance_table_p != nullptr) {
-        return distance_table_p->operator[](i)[state_idx];
-    }
-    return distance_table[i][state_idx];
+    return getDistanceTable()->get(distance_rows[i], s, dir);
 }
 
 void MAPF_Solver::createDistanceTable()
 {
+  basic_distance_table.assign(P->getNum(),
+                              std::vector<int>(G->getNodesSize(), max_timestep));
   for (int i = 0; i < P->getNum(); ++i) {
     // breadth first search
     std::queue<Node*> OPEN;
@@ -319,147 +385,18 @@ void MAPF_Solver::createDistanceTable()
 
 
 void MAPF_Solver::createDistanceTableWithOrientation()
-// get minimal cost to goal from DistanceTable
 {
-    const int nodes_size = G->getNodesSize();
-    const int states_size = nodes_size * 4;
-    for (auto& row : distance_table) {
-        row.resize(states_size, max_timestep);
-    }
-
-    for (int i = 0; i < P->getNum(); ++i) {
-        std::queue<std::pair<Node*, Orientation>> OPEN;
-        Node* goal = P->getGoal(i);
-        
-        for (Orientation goal_dir : {Orientation::X_PLUS, Orientation::X_MINUS, 
-                                   Orientation::Y_PLUS, Orientation::Y_MINUS}) {
-            OPEN.push({goal, goal_dir});
-            distance_table[i][goal->id * 4 + static_cast<int>(goal_dir)] = 0;
-
-            while (!OPEN.empty()) {
-                auto [current_node, current_dir] = OPEN.front();
-                OPEN.pop();
-
-                int current_idx = current_node->id * 4 + static_cast<int>(current_dir);
-                int current_dist = distance_table[i][current_idx];
-
-                std::vector<Orientation> turn_directions;
-                if (current_dir == Orientation::X_PLUS || current_dir == Orientation::X_MINUS) {
-                    turn_directions = {Orientation::Y_PLUS, Orientation::Y_MINUS};
-                } else {
-                    turn_directions = {Orientation::X_PLUS, Orientation::X_MINUS};
-                }
-
-                for (auto new_dir : turn_directions) {
-                    int new_idx = current_node->id * 4 + static_cast<int>(new_dir);
-                    if (current_dist + 1 < distance_table[i][new_idx]) {
-                        distance_table[i][new_idx] = current_dist + 1;
-                        OPEN.push({current_node, new_dir});
-                    }
-                }
-                
-                for (auto next_node : current_node->neighbor) {
-                    Orientation relative_pos = solution.getRelativePosition(current_node, next_node);
-                    Orientation opposite_dir;
-                    if (relative_pos == Orientation::X_PLUS) opposite_dir = Orientation::X_MINUS;
-                    else if (relative_pos == Orientation::X_MINUS) opposite_dir = Orientation::X_PLUS;
-                    else if (relative_pos == Orientation::Y_PLUS) opposite_dir = Orientation::Y_MINUS;
-                    else opposite_dir = Orientation::Y_PLUS;
-
-                    if (current_dir == opposite_dir) {
-                        int next_idx = next_node->id * 4 + static_cast<int>(current_dir);
-                        if (current_dist + 1 < distance_table[i][next_idx]) {
-                            distance_table[i][next_idx] = current_dist + 1;
-                            OPEN.push({next_node, current_dir});
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
-MinimumSolver::AstarNode::AstarNode(Node* _v, int _g, int _f, AstarNode* _p)
-    : v(_v), g(_g), f(_f), p(_p), name(getName(_v, _g))
-{
-}
-
-std::string MinimumSolver::AstarNode::getName(Node* _v, int _g)
-{
-  return std::to_string(_v->id) + "-" + std::to_string(_g);
-}
-
-Path MinimumSolver::getPathBySpaceTimeAstar(
-    Node* const s, Node* const g, AstarHeuristics& fValue,
-    CompareAstarNode& compare, CheckAstarFin& checkAstarFin,
-    CheckInvalidAstarNode& checkInvalidAstarNode, const int time_limit)
-{
-  auto t_start = Time::now();
-
-  AstarNodes GC;  // garbage collection
-  auto createNewNode = [&GC](Node* v, int g, int f, AstarNode* p) {
-    AstarNode* new_node = new AstarNode(v, g, f, p);
-    GC.push_back(new_node);
-    return new_node;
-  };
-
-  // OPEN and CLOSE list
-  std::priority_queue<AstarNode*, AstarNodes, CompareAstarNode> OPEN(compare);
-  std::unordered_map<std::string, bool> CLOSE;
-
-  // initial node
-  AstarNode* n = createNewNode(s, 0, 0, nullptr);
-  n->f = fValue(n);
-  OPEN.push(n);
-
-  // main loop
-  bool invalid = true;
-  while (!OPEN.empty()) {
-    // check time limit
-    if (time_limit > 0 && getElapsedTime(t_start) > time_limit) break;
-
-    // minimum node
-    n = OPEN.top();
-    OPEN.pop();
-
-    // check CLOSE list
-    if (CLOSE.find(n->name) != CLOSE.end()) continue;
-    CLOSE[n->name] = true;
-
-    // check goal condition
-    if (checkAstarFin(n)) {
-      invalid = false;
-      break;
-    }
-
-    // expand
-    Nodes C = n->v->neighbor;
-    C.push_back(n->v);
-    for (auto u : C) {
-      int g_cost = n->g + 1;
-      AstarNode* m = createNewNode(u, g_cost, 0, n);
-      m->f = fValue(m);
-      // already searched?
-      if (CLOSE.find(m->name) != CLOSE.end()) continue;
-      // check constraints
-      if (checkInvalidAstarNode(m)) continue;
-      OPEN.push(m);
-    }
-  }
-
-  Path path;
-  if (!invalid) {  // success
-    while (n != nullptr) {
-      path.push_back(n->v);
-      n = n->p;
-    }
-    std::reverse(path.begin(), path.end());
+  distance_table = std::make_unique<DistanceTable>(G, max_timestep);
+  for (int i = 0; i < P->getNum(); ++i) distance_table->addGoal(P->getGoal(i));
+  if (lazy_distance) {
+    distance_table->setLazy(distance_memory_budget);
+  } else if (use_distance_cache) {
+    DistanceCache cache(G, distance_table->getStride());
+    info("  use distance cache, cached rows:", cache.getRowsSize());
+    distance_table->build(num_threads, &cache);
+  } else {
+    distance_table->build(num_threads);
   }
-
-  // free
-  for (auto p : GC) delete p;
-
-  return path;
 }
 
 MinimumSolver::CompareAstarNode MinimumSolver::compareAstarNodeBasic =
@@ -480,17 +417,12 @@ Path MAPF_Solver::getPrioritizedPath(
   const int ideal_dist = pathDist(id);
   const int makespan = paths.getMakespan();
 
+  // update PATH_TABLE
+  if (manage_path_table) updatePathTable(paths, id);
+
   // max timestep that another agent uses the goal
-  int max_constraint_time = 0;
-  for (int t = makespan; t >= ideal_dist; --t) {
-    for (int i = 0; i < P->getNum(); ++i) {
-      if (i != id && !paths.empty(i) && paths.get(i, t) == g) {
-        max_constraint_time = t;
-        break;
-      }
-    }
-    if (max_constraint_time > 0) break;
-  }
+  const int t_goal = PATH_TABLE.getLatestTime(g, id, makespan);
+  const int max_constraint_time = (t_goal >= ideal_dist) ? t_goal : 0;
 
   // setup functions
 
@@ -501,39 +433,25 @@ Path MAPF_Solver::getPrioritizedPath(
    * the underlying pathfinding is not limited to optimal sub-solution.
    * c.f., classical f-value: n->g + pathDist(id, n->v)
    */
-  AstarHeuristics fValue;
-  if (ideal_dist > max_constraint_time) {
-    fValue = [&](AstarNode* n) { return n->g + pathDist(id, n->v); };
-  } else {
-    // when someone occupies its goal
-    fValue = [&](AstarNode* n) {
-      return std::max(max_constraint_time + 1, n->g + pathDist(id, n->v));
-    };
-  }
+  // when someone occupies its goal, f-value is at least max_constraint_time+1
+  const int min_f = (ideal_dist > max_constraint_time) ? 0
+                                                       : max_constraint_time + 1;
+  auto fValue = [&](AstarNode* n) {
+    return std::max(min_f, n->g + pathDist(id, n->v));
+  };
 
-  CheckAstarFin checkAstarFin = [&](AstarNode* n) {
+  auto checkAstarFin = [&](AstarNode* n) {
     return n->v == g && n->g > max_constraint_time;
   };
 
-  // update PATH_TABLE
-  if (manage_path_table) updatePathTable(paths, id);
-
   // fast collision checking
-  CheckInvalidAstarNode checkInvalidAstarNode = [&](AstarNode* m) {
+  auto checkInvalidAstarNode = [&](AstarNode* m) {
     if (upper_bound != -1 && m->g > upper_bound) return true;
 
-    if (makespan > 0) {
-      if (m->g > makespan) {
-        if (PATH_TABLE[makespan][m->v->id] != NIL) return true;
-      } else {
-        // vertex conflict
-        if (PATH_TABLE[m->g][m->v->id] != NIL) return true;
-        // swap conflict
-        if (PATH_TABLE[m->g][m->p->v->id] != NIL &&
-            PATH_TABLE[m->g - 1][m->v->id] == PATH_TABLE[m->g][m->p->v->id])
-          return true;
-      }
-    }
+    // vertex conflict
+    if (PATH_TABLE.get(m->v, m->g) != NIL) return true;
+    // swap conflict
+    if (PATH_TABLE.isSwapConflict(m->p->v, m->v, m->g)) return true;
 
     // check additional constraints
     for (auto c : constraints) {
@@ -543,8 +461,35 @@ Path MAPF_Solver::getPrioritizedPath(
     return false;
   };
 
-  auto p = getPathBySpaceTimeAstar(s, g, fValue, compare, checkAstarFin,
-                                   checkInvalidAstarNode, time_limit);
+  // safe intervals with additional constraints
+  auto getSafeIntervals = [&](Node* v, SIPP::Intervals& out) {
+    const auto k = out.size();
+    PATH_TABLE.getSafeIntervals(v, 0, out);
+    for (auto c : constraints) {
+      if (std::get<0>(c) != v) continue;
+      const int t = std::get<1>(c);
+      if (t == -1) {
+        SIPP::block(out, k, 1, SIPP::INF);
+      } else {
+        SIPP::block(out, k, t, t);
+      }
+    }
+  };
+
+  // swap conflict
+  auto checkInvalidMove = [&](Node* from, Node* to, const int t) {
+    return PATH_TABLE.isSwapConflict(from, to, t);
+  };
+
+  auto p = use_sipp
+               ? getPathBySIPP(s, g, max_constraint_time + 1, fValue, compare,
+                               getSafeIntervals, checkInvalidMove, upper_bound,
+                               time_limit)
+               : getPathBySpaceTimeAstar(s, g, fValue, compare, checkAstarFin,
+                                         checkInvalidAstarNode, time_limit);
+  TRACE_ASSERT(p.empty() || (p.front() == s && p.back() == g),
+               "invalid path of agent", id);
+  if (p.empty()) TRACE_EVENT("no path, agent:", id);
 
   // clear used path table
   if (manage_path_table) clearPathTable(paths);
@@ -554,57 +499,20 @@ Path MAPF_Solver::getPrioritizedPath(
 
 void MAPF_Solver::updatePathTable(const Paths& paths, const int id)
 {
-  const int makespan = paths.getMakespan();
   const int num_agents = paths.size();
-  const int nodes_size = G->getNodesSize();
-  // extend PATH_TABLE
-  while ((int)PATH_TABLE.size() < makespan + 1)
-    PATH_TABLE.push_back(std::vector<int>(nodes_size, NIL));
-  // update locations
   for (int i = 0; i < num_agents; ++i) {
     if (i == id || paths.empty(i)) continue;
-    auto p = paths.get(i);
-    for (int t = 0; t <= makespan; ++t) PATH_TABLE[t][p[t]->id] = i;
+    PATH_TABLE.insert(paths.get(i), i, 0, true);
   }
 }
 
-void MAPF_Solver::clearPathTable(const Paths& paths)
-{
-  const int makespan = paths.getMakespan();
-  const int num_agents = paths.size();
-  for (int i = 0; i < num_agents; ++i) {
-    if (paths.empty(i)) continue;
-    auto p = paths.get(i);
-    for (int t = 0; t <= makespan; ++t) PATH_TABLE[t][p[t]->id] = NIL;
-  }
-}
+void MAPF_Solver::clearPathTable(const Paths& paths) { PATH_TABLE.clear(); }
 
 void MAPF_Solver::updatePathTableWithoutClear(const int id, const Path& p,
                                               const Paths& paths)
 {
   if (p.empty()) return;
-
-  const int makespan = PATH_TABLE.size() - 1;
-  const int nodes_size = G->getNodesSize();
-  const int p_makespan = p.size() - 1;
-
-  // extend PATH_TABLE
-  if (p_makespan > makespan) {
-    while ((int)PATH_TABLE.size() < p_makespan + 1)
-      PATH_TABLE.push_back(std::vector<int>(nodes_size, NIL));
-    for (int i = 0; i < P->getNum(); ++i) {
-      if (paths.empty(i)) continue;
-      auto v_id = paths.get(i, makespan)->id;
-      for (int t = makespan + 1; t <= p_makespan; ++t) PATH_TABLE[t][v_id] = i;
-    }
-  }
-
-  // register new path
-  for (int t = 0; t <= p_makespan; ++t) PATH_TABLE[t][p[t]->id] = id;
-  if (makespan > p_makespan) {
-    auto v_id = p[p_makespan]->id;
-    for (int t = p_makespan + 1; t <= makespan; ++t) PATH_TABLE[t][v_id] = id;
-  }
+  PATH_TABLE.insert(p, id, 0, true);
 }
 
 //-----------------------------------------------------
@@ -613,9 +521,9 @@ MAPD_Solver::MAPD_Solver(MAPD_Instance* _P, bool _use_distance_table)
     : MinimumSolver(_P),
       P(_P),
       use_distance_table(_use_distance_table),
-      preprocessing_comp_time(0),
-      distance_table(G->getNodesSize(),
-                     std::vector<int>(G->getNodesSize(), G->getNodesSize()))
+      use_distance_cache(false),
+      num_threads(DEFAULT_NUM_THREADS),
+      preprocessing_comp_time(0)
 {
 }
 
@@ -623,10 +531,12 @@ MAPD_Solver::~MAPD_Solver() {}
 
 void MAPD_Solver::solve()
 {
+  openLog();
+
   // create distance table
   if (use_distance_table) {
     auto t_s = Time::now();
-    info("  pre-processing, create distance table by Floyd-Warshall");
+    info("  pre-processing, create distance table by BFS from endpoints");
     createDistanceTable();
     preprocessing_comp_time = getElapsedTime(t_s);
     info("  done, elapsed: ", preprocessing_comp_time);
@@ -641,30 +551,31 @@ void MAPD_Solver::exec() { run(); }
 
 int MAPD_Solver::pathDist(Node* const s, Node* const g) const
 {
-  if (use_distance_table) return distance_table[s->id][g->id];
+  if (use_distance_table) {
+    const int row = distance_table->getRow(g);
+    if (row != DistanceTable::NIL) {
+      const int d = distance_table->get(row, s);
+      return (d == distance_table->getMaxDist()) ? G->getNodesSize() : d;
+    }
+  }
   return G->pathDist(s, g);
 }
 
 void MAPD_Solver::createDistanceTable()
 {
-  const int nodes_num = G->getNodesSize();
-  for (int i = 0; i < nodes_num; ++i) {
-    auto u = G->getNode(i);
-    if (u == nullptr) continue;
-    for (auto v : u->neighbor) {
-      distance_table[i][v->id] = 1;
-    }
-    distance_table[i][i] = 0;
-  }
-
-  // main loop
-  for (int k = 0; k < nodes_num; ++k) {
-    for (int i = 0; i < nodes_num; ++i) {
-      for (int j = 0; j < nodes_num; ++j) {
-        distance_table[i][j] = std::min(
-            distance_table[i][j], distance_table[i][k] + distance_table[k][j]);
-      }
-    }
+  // tasks and agents head to endpoints, otherwise anywhere
+  auto targets = P->getEndpoints();
+  if (targets.empty()) targets = G->getV();
+
+  distance_table = std::make_unique<DistanceTable>(
+      G, std::numeric_limits<DistanceTable::Dist>::max(), false);
+  for (auto v : targets) distance_table->addGoal(v);
+  if (use_distance_cache) {
+    DistanceCache cache(G, distance_table->getStride());
+    info("  use distance cache, cached rows:", cache.getRowsSize());
+    distance_table->build(num_threads, &cache);
+  } else {
+    distance_table->build(num_threads);
   }
 }
 
@@ -695,6 +606,10 @@ void MAPD_Solver::printResult()
 
 void MAPD_Solver::makeLog(const std::string& logfile)
 {
+  if (log_format == LogFormat::BINARY) {
+    makeLogBinary(logfile);
+    return;
+  }
   std::ofstream log;
   log.open(logfile, std::ios::out);
   makeLogBasicInfo(log);
@@ -702,7 +617,7 @@ void MAPD_Solver::makeLog(const std::string& logfile)
   log.close();
 }
 
-void MAPD_Solver::makeLogBasicInfo(std::ofstream& log)
+void MAPD_Solver::makeLogBasicInfo(std::ostream& log)
 {
   Grid* grid = reinterpret_cast<Grid*>(P->getG());
   log << "instance=" << P->getInstanceFileName() << "\n";
@@ -716,10 +631,8 @@ void MAPD_Solver::makeLogBasicInfo(std::ofstream& log)
   log << "preprocessing_comp_time=" << preprocessing_comp_time << "\n";
 }
 
-void MAPD_Solver::makeLogSolution(std::ofstream& log)
+void MAPD_Solver::makeLogInstance(std::ostream& log)
 {
-  if (log_short) return;
-
   log << "starts=";
   for (int i = 0; i < P->getNum(); ++i) {
     Node* v = P->getStart(i);
@@ -733,6 +646,12 @@ void MAPD_Solver::makeLogSolution(std::ofstream& log)
         << "appear=" << task->timestep_appear << ","
         << "finished=" << task->timestep_finished << "\n";
   }
+}
+
+void MAPD_Solver::makeLogSolution(std::ostream& log)
+{
+  if (log_short) return;
+  makeLogInstance(log);
   log << "solution=\n";
   for (int t = 0; t <= solution.getMakespan(); ++t) {
     log << t << ":";
@@ -748,3 +667,54 @@ void MAPD_Solver::makeLogSolution(std::ofstream& log)
     log << "\n";
   }
 }
+
+void MAPD_Solver::makeLogBinary(const std::string& logfile)
+{
+  if (log_writer == nullptr || logfile != log_file) {
+    // not written while solving
+    Grid* grid = reinterpret_cast<Grid*>(P->getG());
+    log_writer = std::make_unique<ResultLogWriter>(
+        logfile, ResultLog::Kind::MAPD, P->getNum(), grid->getWidth());
+    log_rows = 0;
+  }
+  std::ostringstream preamble;
+  makeLogBasicInfo(preamble);
+  if (!log_short) {
+    makeLogInstance(preamble);
+    preamble << "solution=\n";
+    appendLog();
+  }
+  log_writer->close(preamble.str());
+  log_writer.reset();
+}
+
+void MAPD_Solver::openLog()
+{
+  log_writer.reset();
+  log_rows = 0;
+  if (log_format != LogFormat::BINARY || log_file.empty() || log_short) return;
+  Grid* grid = reinterpret_cast<Grid*>(P->getG());
+  log_writer = std::make_unique<ResultLogWriter>(
+      log_file, ResultLog::Kind::MAPD, P->getNum(), grid->getWidth());
+}
+
+void MAPD_Solver::appendLog()
+{
+  if (log_writer == nullptr) return;
+  // a timestep is committed when both the location and the target are known
+  const int rows = std::min(solution.size(), (int)hist_targets.size());
+  if (log_rows > rows) halt("solution was rewritten after logged");
+  std::vector<int> target_ids(P->getNum());
+  std::vector<int> task_ids(P->getNum());
+  Plan::Cursor cursor;
+  for (; log_rows < rows; ++log_rows) {
+    for (int i = 0; i < P->getNum(); ++i) {
+      auto task = hist_tasks[log_rows][i];
+      target_ids[i] = hist_targets[log_rows][i]->id;
+      task_ids[i] = (task == nullptr) ? Task::NIL : task->id;
+    }
+    log_writer->append(solution.getNodeIds(log_rows, cursor).ptr,
+                       solution.getPackedOrientations(log_rows, cursor).ptr,
+                       target_ids.data(), task_ids.data());
+  }
+}
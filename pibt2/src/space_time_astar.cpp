@@ -0,0 +1,38 @@
+#include "../include/space_time_astar.hpp"
+
+SpaceTimeAstar::SpaceTimeAstar() : closed(1024, EMPTY) {}
+
+bool SpaceTimeAstar::isClosed(const Key key) const
+{
+  const std::size_t mask = closed.size() - 1;
+  for (std::size_t k = getSlot(key, mask);; k = (k + 1) & mask) {
+    if (closed[k] == key) return true;
+    if (closed[k] == EMPTY) return false;
+  }
+}
+
+void SpaceTimeAstar::close(const Key key)
+{
+  // keep load factor at most 1/2
+  if ((closed_slots.size() + 1) * 2 > closed.size()) {
+    std::vector<Key> keys;
+    keys.reserve(closed_slots.size());
+    for (auto k : closed_slots) keys.push_back(closed[k]);
+    closed.assign(closed.size() * 2, EMPTY);
+    closed_slots.clear();
+    for (auto k : keys) close(k);
+  }
+  const std::size_t mask = closed.size() - 1;
+  std::size_t k = getSlot(key, mask);
+  while (closed[k] != EMPTY) k = (k + 1) & mask;
+  closed[k] = key;
+  closed_slots.push_back(k);
+}
+
+void SpaceTimeAstar::reset()
+{
+  arena.clear();
+  for (auto k : closed_slots) closed[k] = EMPTY;
+  closed_slots.clear();
+  OPEN.clear();
+}
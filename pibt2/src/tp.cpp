@@ -3,7 +3,9 @@
 const std::string TP::SOLVER_NAME = "TP";
 
 TP::TP(MAPD_Instance* _P, bool _use_distance_table)
-    : MAPD_Solver(_P, _use_distance_table)
+    : MAPD_Solver(_P, _use_distance_table),
+      CONFLICT_TABLE(G->getNodesSize()),
+      use_sipp(false)
 {
   solver_name = TP::SOLVER_NAME;
 }
@@ -13,11 +15,6 @@ void TP::run()
   std::vector<Path> TOKEN(P->getNum());
   Agents A;
 
-  // initialize conflict table
-  {
-    CONFLICT_TABLE.push_back(std::vector<int>(G->getNodesSize(), NIL));
-  }
-
   for (int i = 0; i < P->getNum(); ++i) {
     Node* s = P->getStart(i);
     Agent* a = new Agent{
@@ -106,10 +103,8 @@ void TP::run()
 
         // update conflict table
         {
-          while (CONFLICT_TABLE.size() - 1 < TOKEN[a->id].size() - 1) {
-            CONFLICT_TABLE.push_back(std::vector<int>(G->getNodesSize(), NIL));
-          }
-          CONFLICT_TABLE[P->getCurrentTimestep() + 1][a->v_now->id] = a->id;
+          const int t = P->getCurrentTimestep() + 1;
+          CONFLICT_TABLE.insert(a->v_now, t, t, a->id);
         }
 
         targets[a->id] = a->v_now;
@@ -125,6 +120,7 @@ void TP::run()
 
     hist_targets.push_back(targets);
     hist_tasks.push_back(tasks);
+    appendLog();
 
     Config config(P->getNum(), nullptr);
     for (auto a : A) {
@@ -187,6 +183,7 @@ void TP::run()
     }
     hist_targets.push_back(targets);
     hist_tasks.push_back(tasks);
+    appendLog();
   }
 
   // memory clear
@@ -263,11 +260,11 @@ void TP::updatePath(int i, Node* g, std::vector<Path>& TOKEN)
     }
   }
 
-  AstarHeuristics fValue = [&](AstarNode* n) {
+  auto fValue = [&](AstarNode* n) {
     return n->g + pathDist(n->v, g);
   };
 
-  CheckAstarFin checkAstarFin = [&](AstarNode* n) {
+  auto checkAstarFin = [&](AstarNode* n) {
     return n->v == g && n->g + current_timestep > max_constraint_time;
   };
 
@@ -277,43 +274,80 @@ void TP::updatePath(int i, Node* g, std::vector<Path>& TOKEN)
     token_endpoints[(*(TOKEN[j].end() - 1))->id] = j;
   }
 
-  CheckInvalidAstarNode checkInvalidAstarNode = [&](AstarNode* m) {
+  auto checkInvalidAstarNode = [&](AstarNode* m) {
     auto t = current_timestep + m->g;
     // avoid endpoints
     auto k = token_endpoints[m->v->id];
     if (k != NIL && (int)TOKEN[k].size() - 1 < t) return true;
-    // avoid conflicts
-    if ((int)CONFLICT_TABLE.size() - 1 >= t) {
-      // check vertex conflicts
-      if (CONFLICT_TABLE[t][m->v->id] != NIL) return true;
-      // check swap conflicts
-      if (CONFLICT_TABLE[t][m->p->v->id] != NIL &&
-          CONFLICT_TABLE[t - 1][m->v->id] == CONFLICT_TABLE[t][m->p->v->id])
-        return true;
-    }
+    // check vertex conflicts
+    if (CONFLICT_TABLE.get(m->v, t) != NIL) return true;
+    // check swap conflicts
+    if (CONFLICT_TABLE.isSwapConflict(m->p->v, m->v, t)) return true;
 
     return false;
   };
 
+  // safe intervals, relative to current_timestep
+  auto getSafeIntervals = [&](Node* v, SIPP::Intervals& out) {
+    const auto k_first = out.size();
+    CONFLICT_TABLE.getSafeIntervals(v, current_timestep, out);
+    // others stay at the endpoints of their tokens
+    auto k = token_endpoints[v->id];
+    if (k != NIL) {
+      const int t_inf = std::max(1, (int)TOKEN[k].size() - current_timestep);
+      SIPP::block(out, k_first, t_inf, SIPP::INF);
+    }
+  };
+
+  // swap conflict
+  auto checkInvalidMove = [&](Node* from, Node* to, const int t) {
+    return CONFLICT_TABLE.isSwapConflict(from, to, current_timestep + t);
+  };
+
   // get path
-  auto path = getPathBySpaceTimeAstar(s, g, fValue, compareAstarNodeBasic,
-                                      checkAstarFin, checkInvalidAstarNode,
-                                      getRemainedTime());
+  auto path = use_sipp
+                  ? getPathBySIPP(s, g, max_constraint_time - current_timestep + 1,
+                                  fValue, compareAstarNodeBasic,
+                                  getSafeIntervals, checkInvalidMove, -1,
+                                  getRemainedTime())
+                  : getPathBySpaceTimeAstar(s, g, fValue, compareAstarNodeBasic,
+                                            checkAstarFin, checkInvalidAstarNode,
+                                            getRemainedTime());
 
   if (path.empty()) halt("failed");
 
-  // update conflict table
-  while (CONFLICT_TABLE.size() - 1 < current_timestep + path.size() - 1) {
-    CONFLICT_TABLE.push_back(std::vector<int>(G->getNodesSize(), NIL));
-  }
-
   // update TOKEN
-  for (int _t = 1; _t < (int)path.size(); ++_t) {
-    TOKEN[i].push_back(path[_t]);
+  for (int _t = 1; _t < (int)path.size(); ++_t) TOKEN[i].push_back(path[_t]);
+
+  // update conflict table
+  CONFLICT_TABLE.insert(Path(path.begin() + 1, path.end()), i,
+                        current_timestep + 1);
+}
 
-    // update conflict table
-    CONFLICT_TABLE[current_timestep + _t][path[_t]->id] = i;
+void TP::setParams(int argc, char* argv[])
+{
+  struct option longopts[] = {
+      {"sipp", no_argument, 0, 'S'},
+      {0, 0, 0, 0},
+  };
+  optind = 1;  // reset
+  int opt, longindex;
+  while ((opt = getopt_long(argc, argv, "S", longopts, &longindex)) != -1) {
+    switch (opt) {
+      case 'S':
+        use_sipp = true;
+        break;
+      default:
+        break;
+    }
   }
 }
 
-void TP::printHelp() { printHelpWithoutOption(SOLVER_NAME); }
+void TP::printHelp()
+{
+  std::cout << TP::SOLVER_NAME << "\n"
+            << "  -S --sipp"
+            << "                    "
+            << "use SIPP instead of space-time A* as low-level search"
+            << std::endl;
+}
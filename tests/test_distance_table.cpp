@@ -0,0 +1,100 @@
+#include <distance_cache.hpp>
+#include <distance_table.hpp>
+#include <problem.hpp>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+TEST(DistanceTable, lazy_eviction)
+{
+  auto P = MAPF_Instance("../tests/instances/example.txt");
+  auto G = P.getG();
+  DistanceTable table_eager(G, P.getMaxTimestep());
+  DistanceTable table_lazy(G, P.getMaxTimestep());
+  for (int i = 0; i < P.getNum(); ++i) {
+    table_eager.addGoal(P.getGoal(i));
+    table_lazy.addGoal(P.getGoal(i));
+  }
+  table_eager.build();
+  // only one row is resident, rows are evicted and recomputed
+  table_lazy.setLazy(1);
+
+  for (int i = 0; i < P.getNum(); ++i) {
+    const int row = table_eager.getRow(P.getGoal(i));
+    ASSERT_EQ(row, table_lazy.getRow(P.getGoal(i)));
+    for (auto v : G->getV()) {
+      if (v == nullptr) continue;
+      ASSERT_EQ(table_eager.get(row, v), table_lazy.get(row, v));
+      ASSERT_EQ(table_eager.get(row, v, Orientation::Y_MINUS),
+                table_lazy.get(row, v, Orientation::Y_MINUS));
+    }
+  }
+  ASSERT_GT(table_lazy.getEvictedCnt(), 0);
+}
+
+
+TEST(DistanceTable, any_orientation)
+{
+  auto P = MAPF_Instance("../tests/instances/example.txt");
+  auto G = P.getG();
+  DistanceTable table(G, P.getMaxTimestep());
+  for (int i = 0; i < P.getNum(); ++i) table.addGoal(P.getGoal(i));
+  table.build(2);
+
+  for (int row = 0; row < table.getRowsSize(); ++row) {
+    for (auto v : G->getV()) {
+      if (v == nullptr) continue;
+      int d = table.getMaxDist();
+      for (auto dir : {Orientation::X_PLUS, Orientation::Y_PLUS,
+                       Orientation::X_MINUS, Orientation::Y_MINUS}) {
+        d = std::min(d, table.get(row, v, dir));
+      }
+      ASSERT_EQ(table.get(row, v), d);
+    }
+  }
+}
+
+
+TEST(DistanceCache, cold_and_warm)
+{
+  auto P = MAPF_Instance("../tests/instances/example.txt");
+  auto G = P.getG();
+  // never touch the cache next to the map
+  char dir_template[] = "/tmp/test_distance_cache_XXXXXX";
+  const std::string dir = mkdtemp(dir_template);
+  const std::string file =
+      DistanceCache::getFileName(G, DistanceTable::ORIENTATIONS, dir);
+  ASSERT_EQ(file.rfind(dir, 0), 0);
+
+  DistanceTable table(G, P.getMaxTimestep());
+  for (int i = 0; i < P.getNum(); ++i) table.addGoal(P.getGoal(i));
+  table.build();
+
+  // cold start, rows are computed and stored
+  {
+    DistanceCache cache(G, DistanceTable::ORIENTATIONS, dir);
+    ASSERT_EQ(cache.getRowsSize(), 0);
+    DistanceTable table_cold(G, P.getMaxTimestep());
+    for (int i = 0; i < P.getNum(); ++i) table_cold.addGoal(P.getGoal(i));
+    table_cold.build(1, &cache);
+  }
+
+  // warm start, all rows are loaded
+  DistanceCache cache(G, DistanceTable::ORIENTATIONS, dir);
+  ASSERT_EQ(cache.getRowsSize(), table.getRowsSize());
+  DistanceTable table_warm(G, P.getMaxTimestep());
+  for (int i = 0; i < P.getNum(); ++i) table_warm.addGoal(P.getGoal(i));
+  table_warm.build(1, &cache);
+  for (int row = 0; row < table.getRowsSize(); ++row) {
+    for (auto v : G->getV()) {
+      if (v == nullptr) continue;
+      ASSERT_EQ(table.get(row, v, Orientation::X_PLUS),
+                table_warm.get(row, v, Orientation::X_PLUS));
+    }
+  }
+  std::remove(file.c_str());
+  rmdir(dir.c_str());
+}
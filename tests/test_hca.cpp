@@ -11,3 +11,17 @@ TEST(HCA, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(HCA, solve_by_sipp)
+{
+  auto P = MAPF_Instance("../tests/instances/example.txt");
+  auto solver = std::make_unique<HCA>(&P);
+  char arg0[] = "";
+  char arg1[] = "--sipp";
+  char* argv[] = {arg0, arg1};
+  solver->setParams(2, argv);
+  solver->solve();
+
+  ASSERT_TRUE(solver->succeed());
+  ASSERT_TRUE(solver->getSolution().validate(&P));
+}
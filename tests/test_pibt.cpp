@@ -2,6 +2,21 @@
 
 #include "gtest/gtest.h"
 
+// same locations and orientations at every timestep
+static void assertSamePlan(const Plan& plan1, const Plan& plan2)
+{
+  ASSERT_EQ(plan1.getMakespan(), plan2.getMakespan());
+  ASSERT_EQ(plan1.getNodeIds(0).size(), plan2.getNodeIds(0).size());
+  for (int t = 0; t <= plan1.getMakespan(); ++t) {
+    auto ids1 = plan1.getNodeIds(t);
+    auto ids2 = plan2.getNodeIds(t);
+    for (int i = 0; i < ids1.size(); ++i) {
+      ASSERT_EQ(ids1[i], ids2[i]);
+      ASSERT_EQ(plan1.getOrientation(t, i), plan2.getOrientation(t, i));
+    }
+  }
+}
+
 TEST(PIBT, solve)
 {
   auto P = MAPF_Instance("../tests/instances/example.txt");
@@ -11,3 +26,75 @@ TEST(PIBT, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(PIBT, parallel_distance_table)
+{
+  auto P1 = MAPF_Instance("../tests/instances/example.txt");
+  auto solver1 = std::make_unique<PIBT>(&P1);
+  solver1->solve();
+
+  auto P2 = MAPF_Instance("../tests/instances/example.txt");
+  auto solver2 = std::make_unique<PIBT>(&P2);
+  solver2->setNumThreads(4);
+  solver2->solve();
+
+  assertSamePlan(solver1->getSolution(), solver2->getSolution());
+}
+
+TEST(PIBT, lazy_distance_table)
+{
+  auto P1 = MAPF_Instance("../tests/instances/example.txt");
+  auto solver1 = std::make_unique<PIBT>(&P1);
+  solver1->solve();
+
+  auto P2 = MAPF_Instance("../tests/instances/example.txt");
+  auto solver2 = std::make_unique<PIBT>(&P2);
+  solver2->setLazyDistanceTable(0);
+  solver2->solve();
+
+  assertSamePlan(solver1->getSolution(), solver2->getSolution());
+}
+
+TEST(PIBT, metrics)
+{
+  auto P = MAPF_Instance("../tests/instances/example.txt");
+  auto solver = std::make_unique<PIBT>(&P);
+  solver->solve();
+  ASSERT_TRUE(solver->succeed());
+
+  auto plan = solver->getSolution();
+  auto metrics = solver->getMetrics();
+  ASSERT_EQ(metrics.size(), plan.getMakespan());
+  for (int t = 0; t < plan.getMakespan(); ++t) {
+    int forward_moves = 0;
+    int rotations = 0;
+    for (int i = 0; i < P.getNum(); ++i) {
+      if (plan.get(t, i) != plan.get(t + 1, i)) {
+        ++forward_moves;
+      } else if (plan.getOrientation(t, i) != plan.getOrientation(t + 1, i)) {
+        ++rotations;
+      }
+    }
+    ASSERT_EQ(metrics[t].forward_moves, forward_moves);
+    ASSERT_EQ(metrics[t].rotations, rotations);
+    ASSERT_GE(metrics[t].funcpibt_calls, 1);
+    ASSERT_GE(metrics[t].latency_us, 0);
+  }
+
+  ASSERT_EQ(PIBT::getMetricsFileName("./result.txt", "csv"),
+            "./result_metrics.csv");
+  ASSERT_EQ(PIBT::getMetricsFileName("../out/result", "json"),
+            "../out/result_metrics.json");
+}
+
+TEST(PIBT, livelock)
+{
+  auto P = MAPF_Instance("../tests/instances/tunnel.txt");
+  auto solver = std::make_unique<PIBT>(&P);
+  solver->setLivelockWindow(20);
+  solver->solve();
+
+  ASSERT_FALSE(solver->succeed());
+  ASSERT_GT(solver->getLivelockPeriod(), 0);
+  ASSERT_LT(solver->getSolution().getMakespan(), P.getMaxTimestep());
+}
@@ -11,3 +11,27 @@ TEST(PIBT_MAPD, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(PIBT_MAPD, endpoint_distance_table)
+{
+  auto P = MAPD_Instance("../tests/instances/test_mapd_pibt_ins.txt");
+  auto G = P.getG();
+
+  // BFS without orientation agrees with the graph
+  DistanceTable table(G, P.getMaxTimestep(), false);
+  for (auto v : P.getEndpoints()) table.addGoal(v);
+  table.build(4);
+  for (auto g : P.getEndpoints()) {
+    const int row = table.getRow(g);
+    for (auto v : G->getV()) {
+      if (v == nullptr) continue;
+      ASSERT_EQ(table.get(row, v), G->pathDist(v, g));
+    }
+  }
+
+  auto solver = std::make_unique<PIBT_MAPD>(&P, true);
+  solver->solve();
+
+  ASSERT_TRUE(solver->succeed());
+  ASSERT_TRUE(solver->getSolution().validate(&P));
+}
@@ -11,3 +11,15 @@ TEST(PIBT_PLUS, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(PIBT_PLUS, livelock)
+{
+  auto P = MAPF_Instance("../tests/instances/tunnel.txt");
+  auto solver = std::make_unique<PIBT_PLUS>(&P);
+  char* argv[] = {(char*)"", (char*)"-w", (char*)"20"};
+  solver->setParams(3, argv);
+  solver->solve();
+
+  ASSERT_TRUE(solver->succeed());
+  ASSERT_TRUE(solver->getSolution().validate(&P));
+}
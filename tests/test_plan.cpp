@@ -129,4 +129,186 @@ TEST(Plan, maxConstraintTime)
   plan.add({u, w});
   ASSERT_EQ(plan.getMaxConstraintTime(0, v, u, &G), 1);
   ASSERT_EQ(plan.getMaxConstraintTime(1, u, w, &G), 0);
+
+  // the index follows added configurations
+  plan.add({u, w});
+  plan.add({w, u});
+  ASSERT_EQ(plan.getMaxConstraintTime(0, v, u, &G), 1);
+  ASSERT_EQ(plan.getMaxConstraintTime(0, u, w, &G), 3);
+}
+
+TEST(Plan, computeAction)
+{
+  Grid G("8x8.map");
+  Node* v = G.getNode(1, 1);
+  Node* right = G.getNode(2, 1);
+  Node* down = G.getNode(1, 2);
+
+  static_assert(rotateCounterClockwise(Orientation::Y_MINUS) ==
+                Orientation::X_PLUS);
+  static_assert(getOpposite(Orientation::Y_PLUS) == Orientation::Y_MINUS);
+  static_assert(getAngleDifference(Orientation::X_PLUS, Orientation::Y_MINUS) ==
+                90);
+  ASSERT_EQ(getAdjacent(v, Orientation::X_PLUS), right);
+  ASSERT_EQ(getAdjacent(G.getNode(0, 0), Orientation::X_MINUS), nullptr);
+  ASSERT_EQ(*getRelativeOrientation(v, down), Orientation::Y_PLUS);
+  ASSERT_FALSE(getRelativeOrientation(right, down));
+
+  Plan plan;
+  auto a1 = plan.computeAction(v, right, Orientation::X_PLUS);
+  ASSERT_EQ(a1.first, right);
+  ASSERT_EQ(a1.second, Orientation::X_PLUS);
+  auto a2 = plan.computeAction(v, down, Orientation::X_PLUS);
+  ASSERT_EQ(a2.first, v);
+  ASSERT_EQ(a2.second, Orientation::Y_PLUS);
+  auto a3 = plan.computeAction(v, right, Orientation::X_MINUS);
+  ASSERT_EQ(a3.first, v);
+  ASSERT_EQ(a3.second, Orientation::Y_MINUS);
+}
+
+TEST(Plan, deltaLayer)
+{
+  Grid G("8x8.map");
+  std::mt19937 MT(0);
+
+  // random walks of five agents with orientations
+  const int num_agents = 5;
+  Configs configs;
+  std::vector<std::vector<Orientation>> orientations;
+  Config c(num_agents);
+  std::vector<Orientation> orients(num_agents);
+  for (int i = 0; i < num_agents; ++i) c[i] = G.getNode(9 * i);
+  for (int t = 0; t < 30; ++t) {
+    for (int i = 0; i < num_agents; ++i) {
+      if (getRandomBoolean(&MT)) c[i] = randomChoose(c[i]->neighbor, &MT);
+      if (getRandomBoolean(&MT)) {
+        orients[i] = static_cast<Orientation>(getRandomInt(0, 3, &MT));
+      }
+    }
+    configs.push_back(c);
+    orientations.push_back(orients);
+  }
+
+  Plan dense;
+  Plan delta;
+  delta.setKeyframeInterval(4);
+  for (int t = 0; t < (int)configs.size(); ++t) {
+    dense.addWithOrientation(configs[t], orientations[t]);
+    delta.addWithOrientation(configs[t], orientations[t]);
+  }
+
+  // random access
+  for (int k = 0; k < 100; ++k) {
+    const int t = getRandomInt(0, configs.size() - 1, &MT);
+    const int i = getRandomInt(0, num_agents - 1, &MT);
+    ASSERT_EQ(delta.get(t, i), configs[t][i]);
+    ASSERT_EQ(delta.getOrientation(t, i), orientations[t][i]);
+    ASSERT_EQ(dense.get(t, i), configs[t][i]);
+    ASSERT_EQ(dense.getOrientation(t, i), orientations[t][i]);
+  }
+  int soc = 0;
+  for (int i = 0; i < num_agents; ++i) {
+    ASSERT_EQ(delta.getPath(i), dense.getPath(i));
+    ASSERT_EQ(delta.getPathCost(i), getPathCost(dense.getPath(i)));
+    soc += dense.getPathCost(i);
+  }
+  ASSERT_EQ(delta.getSOC(), soc);
+  ASSERT_EQ(dense.getSOC(), soc);
+  auto ids = dense.getNodeIds(7);
+  ASSERT_EQ(ids.size(), num_agents);
+  ASSERT_EQ(ids[2], configs[7][2]->id);
+
+  // rows restored by cursors, forward, backward and interleaved
+  Plan::Cursor cursor1;
+  Plan::Cursor cursor2;
+  for (int t = 0; t < delta.size(); ++t) {
+    const int s = delta.getMakespan() - t;
+    auto ids1 = delta.getNodeIds(t, cursor1);
+    auto ids2 = delta.getNodeIds(s, cursor2);
+    auto otts1 = delta.getPackedOrientations(t, cursor1);
+    for (int i = 0; i < num_agents; ++i) {
+      ASSERT_EQ(ids1[i], configs[t][i]->id);
+      ASSERT_EQ(ids2[i], configs[s][i]->id);
+      ASSERT_EQ(otts1[i / 4], dense.getPackedOrientations(t)[i / 4]);
+    }
+  }
+  ASSERT_EQ(delta.getNodeIds(8)[3], configs[8][3]->id);  // keyframe
+
+  // rewrite orientations of the last configuration
+  std::vector<Orientation> orients_last(num_agents, Orientation::Y_MINUS);
+  delta.addOrientation(orients_last);
+  dense.addOrientation(orients_last);
+  ASSERT_EQ(delta.getOrientations(delta.getMakespan()), orients_last);
+  ASSERT_EQ(dense.getOrientations(dense.getMakespan()), orients_last);
+  ASSERT_EQ(delta.getOrientations(20), orientations[20]);
+
+  // join keeps orientations
+  Plan joined;
+  joined += delta;
+  ASSERT_EQ(joined.size(), delta.size());
+  ASSERT_EQ(joined.getOrientations(3), orientations[3]);
+  ASSERT_EQ(joined.getOrientations(joined.getMakespan()), orients_last);
+}
+
+TEST(Plan, validateOrientation)
+{
+  Grid G("8x8.map");
+  Node* v = G.getNode(0, 0);
+  Node* u = G.getNode(1, 0);
+  const auto X_PLUS = Orientation::X_PLUS;
+  const auto Y_PLUS = Orientation::Y_PLUS;
+  const auto X_MINUS = Orientation::X_MINUS;
+
+  // rotate, then move forward
+  Plan plan0;
+  plan0.addWithOrientation({v}, {Y_PLUS});
+  plan0.addWithOrientation({v}, {X_PLUS});
+  plan0.addWithOrientation({u}, {X_PLUS});
+  ASSERT_TRUE(plan0.hasOrientations());
+  ASSERT_TRUE(plan0.validate({v}, {u}, 4));
+
+  // rotate by 180 degrees
+  Plan plan1;
+  plan1.addWithOrientation({v}, {X_PLUS});
+  plan1.addWithOrientation({v}, {X_MINUS});
+  ASSERT_FALSE(plan1.validate({v}));
+
+  // move without facing the direction
+  Plan plan2;
+  plan2.addWithOrientation({v}, {Y_PLUS});
+  plan2.addWithOrientation({u}, {Y_PLUS});
+  ASSERT_FALSE(plan2.validate({v}));
+
+  // plans without orientations are checked only by locations
+  Plan plan3;
+  plan3.add({u});
+  plan3.add({v});
+  ASSERT_FALSE(plan3.hasOrientations());
+  ASSERT_TRUE(plan3.validate({u}));
+  plan2 += plan3;
+  ASSERT_FALSE(plan2.hasOrientations());
+}
+
+TEST(Plan, validateParallel)
+{
+  Grid G("8x8.map");
+
+  // agents go around a 2x2 block, one step per timestep
+  Node* a = G.getNode(0, 0);
+  Node* b = G.getNode(1, 0);
+  Node* c = G.getNode(1, 1);
+  Node* d = G.getNode(0, 1);
+  Config cycle = {a, b, c, d};
+  for (int k = 0; k < 2; ++k) {
+    Plan plan;
+    plan.setKeyframeInterval(k * 8);
+    for (int t = 0; t < 100; ++t) {
+      plan.add({cycle[t % 4], cycle[(t + 2) % 4]});
+    }
+    ASSERT_TRUE(plan.validate(plan.get(0), 4));
+
+    // vertex conflict at the end
+    plan.add({cycle[0], cycle[0]});
+    ASSERT_FALSE(plan.validate(plan.get(0), 4));
+  }
 }
@@ -1,3 +1,5 @@
+#include <cstdio>
+#include <fstream>
 #include <plan.hpp>
 #include <problem.hpp>
 
@@ -63,3 +65,83 @@ TEST(MAPD_Instance, load)
     ASSERT_TRUE(int(P.getOpenTasks().size()) <= P.getTaskNum());
   }
 }
+
+TEST(Graph, corridors)
+{
+  Grid G("tunnel.map");
+  Node* junction = G.getNode(0, 1);
+  ASSERT_EQ(G.getCorridorId(junction), -1);
+  ASSERT_EQ(G.getJunctions(), Nodes({junction}));
+
+  // dead end
+  auto [last, next] = G.passCorridor(junction, G.getNode(0, 2));
+  ASSERT_EQ(last, G.getNode(0, 5));
+  ASSERT_EQ(next, nullptr);
+  // back to the junction
+  std::tie(last, next) = G.passCorridor(G.getNode(0, 4), G.getNode(0, 3));
+  ASSERT_EQ(last, G.getNode(0, 2));
+  ASSERT_EQ(next, junction);
+  ASSERT_TRUE(
+      G.isOnCorridorSection(G.getNode(0, 3), G.getNode(0, 5), G.getNode(0, 2)));
+  ASSERT_FALSE(
+      G.isOnCorridorSection(G.getNode(2, 1), G.getNode(0, 5), G.getNode(0, 2)));
+
+  // both ends are attached to the same junction
+  Grid H("loop-chain.map");
+  junction = H.getNode(2, 0);
+  ASSERT_EQ(H.getJunctions(), Nodes({junction}));
+  std::tie(last, next) = H.passCorridor(junction, H.getNode(1, 0));
+  ASSERT_EQ(last, H.getNode(2, 1));
+  ASSERT_EQ(next, junction);
+  std::tie(last, next) = H.passCorridor(junction, H.getNode(3, 0));
+  ASSERT_EQ(last, H.getNode(3, 0));
+  ASSERT_EQ(next, nullptr);
+}
+
+TEST(Graph, loading)
+{
+  Grid G("tunnel.map");
+  ASSERT_EQ(G.getWidth(), 4);
+  ASSERT_EQ(G.getHeight(), 6);
+  ASSERT_EQ(G.getNodesSize(), 24);
+  ASSERT_EQ(G.getNode(1, 0), nullptr);
+
+  // left, right, up, down
+  Node* v = G.getNode(0, 1);
+  ASSERT_EQ(v->id, 4);
+  ASSERT_EQ(Nodes(v->neighbor),
+            Nodes({G.getNode(1, 1), G.getNode(0, 0), G.getNode(0, 2)}));
+  ASSERT_EQ(v->adjacent[0], G.getNode(1, 1));
+  ASSERT_EQ(v->adjacent[2], nullptr);
+  v = G.getNode(2, 1);
+  ASSERT_EQ(Nodes(v->neighbor), Nodes({G.getNode(1, 1), G.getNode(3, 1)}));
+}
+
+TEST(MappedFile, lines)
+{
+  const std::string file = "./test_mapped_file.txt";
+  std::ofstream(file) << "agents=3\r\n\n1,2,3,4\r\nlast";
+  MappedFile mapped(file);
+  ASSERT_TRUE(mapped.isOpen());
+
+  std::string_view line, value;
+  int x = 0;
+  ASSERT_TRUE(mapped.getLine(line));
+  ASSERT_TRUE(parseKey(line, "agents", value));
+  ASSERT_TRUE(parseDigits(value, x));
+  ASSERT_EQ(x, 3);
+  ASSERT_TRUE(mapped.getLine(line));
+  ASSERT_TRUE(line.empty());
+  ASSERT_TRUE(mapped.getLine(line));
+  int sg[4];
+  ASSERT_TRUE(parseDigitsList(line, sg));
+  ASSERT_EQ(sg[3], 4);
+  int s[2];
+  ASSERT_FALSE(parseDigitsList(line, s));
+  ASSERT_TRUE(mapped.getLine(line));
+  ASSERT_EQ(line, "last");
+  ASSERT_FALSE(mapped.getLine(line));
+
+  ASSERT_FALSE(MappedFile("./not_found.txt").isOpen());
+  std::remove(file.c_str());
+}
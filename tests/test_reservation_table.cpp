@@ -0,0 +1,70 @@
+#include <reservation_table.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(ReservationTable, insert_and_remove)
+{
+  Grid G("8x8.map");
+  Node* v = G.getNode(0);
+  Node* u = G.getNode(1);
+  Node* w = G.getNode(2);
+  const int NIL = ReservationTable::NIL;
+
+  ReservationTable table(G.getNodesSize());
+  table.insert({v, v, u, w}, 0, 0, true);  // agent-0: v, v, u, w, w, ...
+  table.insert({w, u, v}, 1, 0);           // agent-1: w, u, v
+  ASSERT_EQ(table.get(v, 0), 0);
+  ASSERT_EQ(table.get(v, 1), 0);
+  ASSERT_EQ(table.get(v, 2), 1);
+  ASSERT_EQ(table.get(v, 3), NIL);
+  ASSERT_EQ(table.get(u, 1), 1);
+  ASSERT_EQ(table.get(u, 2), 0);
+  ASSERT_EQ(table.get(w, 0), 1);
+  ASSERT_EQ(table.get(w, 3), 0);
+  ASSERT_EQ(table.get(w, 1000), 0);
+
+  // latest use by others
+  ASSERT_EQ(table.getLatestTime(v, 0, 100), 2);
+  ASSERT_EQ(table.getLatestTime(v, 1, 100), 1);
+  ASSERT_EQ(table.getLatestTime(w, 1, 100), 100);
+  ASSERT_EQ(table.getLatestTime(w, 0, 100), 0);
+  ASSERT_EQ(table.getLatestTime(G.getNode(3), 0, 100), NIL);
+
+  // agent-1 moves u -> v at t=2 while agent-0 moves v -> u
+  ASSERT_TRUE(table.isSwapConflict(u, v, 2));
+  ASSERT_FALSE(table.isSwapConflict(u, v, 3));
+
+  // safe intervals of v after t=0: [0, 0], [3, INF]
+  SIPP::Intervals I;
+  table.getSafeIntervals(v, 0, I);
+  ASSERT_EQ(I.size(), 2);
+  ASSERT_EQ(I[0].lo, 0);
+  ASSERT_EQ(I[0].hi, 0);
+  ASSERT_EQ(I[1].lo, 3);
+  ASSERT_EQ(I[1].hi, SIPP::INF);
+
+  // w is blocked forever from t=3, occupancy at t=0 is ignored
+  I.clear();
+  table.getSafeIntervals(w, 0, I);
+  ASSERT_EQ(I.size(), 1);
+  ASSERT_EQ(I[0].lo, 0);
+  ASSERT_EQ(I[0].hi, 2);
+
+  // consecutive insertions of one agent are merged
+  table.insert(v, 3, 3, 1);
+  table.insert(v, 4, 4, 1);
+  ASSERT_EQ(table.get(v, 4), 1);
+  ASSERT_EQ(table.getReservationsSize(), 6);
+
+  table.remove({w, u, v}, 1, 0);
+  ASSERT_EQ(table.get(w, 0), NIL);
+  ASSERT_EQ(table.get(v, 2), NIL);
+  ASSERT_EQ(table.get(v, 3), 1);
+  table.remove(v, 3, 4, 1);
+  ASSERT_EQ(table.get(v, 3), NIL);
+  ASSERT_EQ(table.get(v, 1), 0);
+
+  table.clear();
+  ASSERT_EQ(table.get(w, 1000), NIL);
+  ASSERT_EQ(table.getReservationsSize(), 0);
+}
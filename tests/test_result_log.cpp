@@ -0,0 +1,152 @@
+#include <pibt.hpp>
+#include <pibt_mapd.hpp>
+#include <result_log.hpp>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+static std::string readFile(const std::string& file)
+{
+  std::ifstream in(file);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+TEST(ResultLog, seek)
+{
+  const std::string file = "./test_result_log.bin";
+  const int num_agents = 6;
+  const int width = 10;
+  const int timesteps = 50;
+  std::mt19937 MT(0);
+
+  // random walks with jumps, turns, targets and tasks
+  std::vector<ResultLog::Row> rows(timesteps);
+  ResultLogWriter writer(file, ResultLog::Kind::MAPD, num_agents, width, 4);
+  for (int t = 0; t < timesteps; ++t) {
+    auto& row = rows[t];
+    std::vector<std::uint8_t> packed((num_agents + 3) / 4, 0);
+    for (int i = 0; i < num_agents; ++i) {
+      const int d[] = {0, 1, -1, width, -width, 37};
+      const int v = (t == 0) ? 50 + i : rows[t - 1].node_ids[i] + d[MT() % 6];
+      row.node_ids.push_back(std::max(0, v));
+      row.otts.push_back(static_cast<Orientation>(MT() % 4));
+      row.target_ids.push_back(MT() % 3 == 0 ? MT() % 100 : 7);
+      row.task_ids.push_back(MT() % 3 == 0 ? (int)(MT() % 5) - 1 : 2);
+      packed[i / 4] |= toIndex(row.otts[i]) << (2 * (i % 4));
+    }
+    writer.append(row.node_ids.data(), packed.data(), row.target_ids.data(),
+                  row.task_ids.data());
+  }
+  writer.close("solution=\n");
+
+  ResultLogReader reader(file);
+  ASSERT_EQ(reader.getKind(), ResultLog::Kind::MAPD);
+  ASSERT_EQ(reader.getNumAgents(), num_agents);
+  ASSERT_EQ(reader.getTimesteps(), timesteps);
+  ASSERT_EQ(reader.getPreamble(), "solution=\n");
+  ResultLog::Row row;
+  for (int t = timesteps - 1; t >= 0; --t) {
+    reader.read(t, row);
+    ASSERT_EQ(row.node_ids, rows[t].node_ids);
+    ASSERT_EQ(row.otts, rows[t].otts);
+    ASSERT_EQ(row.target_ids, rows[t].target_ids);
+    ASSERT_EQ(row.task_ids, rows[t].task_ids);
+  }
+  std::remove(file.c_str());
+}
+
+TEST(ResultLog, mapf)
+{
+  const std::string text_file = "./test_result_log.txt";
+  const std::string binary_file = "./test_result_log.bin";
+  auto P = MAPF_Instance("../tests/instances/example.txt");
+  auto solver = std::make_unique<PIBT>(&P);
+  solver->solve();
+  solver->makeLog(text_file);
+  solver->setLogFormat(LogFormat::BINARY);
+  solver->makeLog(binary_file);
+
+  ASSERT_TRUE(ResultLogReader::isBinary(binary_file));
+  ASSERT_FALSE(ResultLogReader::isBinary(text_file));
+  ResultLogReader reader(binary_file);
+  std::stringstream ss;
+  reader.toText(ss);
+  ASSERT_EQ(ss.str(), readFile(text_file));
+
+  auto plan = solver->getSolution();
+  ResultLog::Row row;
+  for (int t = 0; t <= plan.getMakespan(); ++t) {
+    reader.read(t, row);
+    for (int i = 0; i < P.getNum(); ++i) {
+      ASSERT_EQ(row.node_ids[i], plan.get(t, i)->id);
+      ASSERT_EQ(row.otts[i], plan.getOrientation(t, i));
+    }
+  }
+  std::remove(text_file.c_str());
+  std::remove(binary_file.c_str());
+}
+
+TEST(ResultLog, mapd)
+{
+  const std::string text_file = "./test_result_log.txt";
+  const std::string binary_file = "./test_result_log.bin";
+  auto P = MAPD_Instance("../tests/instances/test_mapd_pibt_ins.txt");
+  auto solver = std::make_unique<PIBT_MAPD>(&P);
+  solver->solve();
+  solver->makeLog(text_file);
+  solver->setLogFormat(LogFormat::BINARY);
+  solver->makeLog(binary_file);
+
+  ResultLogReader reader(binary_file);
+  std::stringstream ss;
+  reader.toText(ss);
+  ASSERT_EQ(ss.str(), readFile(text_file));
+  std::remove(text_file.c_str());
+  std::remove(binary_file.c_str());
+}
+
+TEST(ResultLog, whileSolving)
+{
+  const std::string text_file = "./test_result_log.txt";
+  const std::string binary_file = "./test_result_log.bin";
+
+  // MAPF, timesteps are appended by PIBT
+  {
+    auto P = MAPF_Instance("../tests/instances/example.txt");
+    auto solver = std::make_unique<PIBT>(&P);
+    solver->setLogFormat(LogFormat::BINARY);
+    solver->setLogFile(binary_file);
+    solver->solve();
+    solver->makeLog(binary_file);
+    solver->setLogFormat(LogFormat::TEXT);
+    solver->makeLog(text_file);
+
+    ResultLogReader reader(binary_file);
+    std::stringstream ss;
+    reader.toText(ss);
+    ASSERT_EQ(ss.str(), readFile(text_file));
+  }
+
+  // MAPD
+  {
+    auto P = MAPD_Instance("../tests/instances/test_mapd_pibt_ins.txt");
+    auto solver = std::make_unique<PIBT_MAPD>(&P);
+    solver->setLogFormat(LogFormat::BINARY);
+    solver->setLogFile(binary_file);
+    solver->solve();
+    solver->makeLog(binary_file);
+    solver->setLogFormat(LogFormat::TEXT);
+    solver->makeLog(text_file);
+
+    ResultLogReader reader(binary_file);
+    std::stringstream ss;
+    reader.toText(ss);
+    ASSERT_EQ(ss.str(), readFile(text_file));
+  }
+  std::remove(text_file.c_str());
+  std::remove(binary_file.c_str());
+}
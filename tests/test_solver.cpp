@@ -26,3 +26,94 @@ TEST(planToPaths, convert)
   ASSERT_EQ(plan2.get(1, 0), u);
   ASSERT_EQ(plan2.get(1, 1), x);
 }
+
+TEST(SpaceTimeAstar, search)
+{
+  Grid G("8x8.map");
+  Node* s = G.getNode(0);
+  Node* g = G.getNode(63);
+  Node* blocked = G.getNode(9);
+  using AstarNode = SpaceTimeAstar::AstarNode;
+
+  SpaceTimeAstar astar;
+  auto fValue = [&](AstarNode* n) { return n->g + G.pathDist(n->v, g); };
+  auto compare = [](AstarNode* a, AstarNode* b) {
+    if (a->f != b->f) return a->f > b->f;
+    return a->g < b->g;
+  };
+  auto checkAstarFin = [&](AstarNode* n) { return n->v == g; };
+  auto checkInvalidAstarNode = [&](AstarNode* m) { return m->v == blocked; };
+
+  // the engine is reused, results must not depend on previous searches
+  for (int k = 0; k < 3; ++k) {
+    auto path = astar.search(s, fValue, compare, checkAstarFin,
+                             checkInvalidAstarNode);
+    ASSERT_EQ(path.size(), 15);
+    ASSERT_EQ(path.front(), s);
+    ASSERT_EQ(path.back(), g);
+    ASSERT_FALSE(inArray(blocked, path));
+  }
+
+  // unreachable, time limited by the constraint
+  auto path = astar.search(
+      s, fValue, compare, checkAstarFin,
+      [&](AstarNode* m) { return m->g > 5; });
+  ASSERT_TRUE(path.empty());
+}
+
+TEST(Util, resortRuns)
+{
+  // (elapsed, tie-breaker) in descending order, before the update:
+  // {3, 1}, {2, 5}, {2, 0}, {0, 4}, {0, 2}
+  using Key = std::pair<int, int>;
+  auto compare = [](const Key& a, const Key& b) { return a > b; };
+  // increment, reset, increment, stay, increment
+  std::vector<Key> updated = {{4, 1}, {0, 5}, {3, 0}, {0, 4}, {1, 2}};
+  std::vector<int> runs = {0, -1, 0, 1, 0};
+  std::vector<int> ids = {0, 1, 2, 3, 4};
+  resortRuns(
+      ids, 2,
+      [&](int i, int j) { return compare(updated[i], updated[j]); },
+      [&](int i) { return runs[i]; });
+  ASSERT_EQ(ids, std::vector<int>({0, 2, 4, 1, 3}));
+}
+
+TEST(Util, StampedArray)
+{
+  StampedArray<int> arr(4, -1);
+  ASSERT_EQ(arr.size(), 4);
+  ASSERT_EQ(arr[2], -1);
+
+  arr.set(2, 5);
+  arr.set(3, 7);
+  ASSERT_EQ(arr[2], 5);
+  ASSERT_TRUE(arr.isSet(3));
+  ASSERT_FALSE(arr.isSet(0));
+
+  arr.clear();
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(arr[i], -1);
+    ASSERT_FALSE(arr.isSet(i));
+  }
+  arr.set(3, 1);
+  ASSERT_EQ(arr[3], 1);
+  ASSERT_EQ(arr[2], -1);
+}
+
+TEST(Util, sortFive)
+{
+  for (int n = 1; n <= 5; ++n) {
+    std::vector<std::uint64_t> arr(n);
+    std::iota(arr.begin(), arr.end(), 0);
+    do {
+      std::uint64_t keys[5] = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX,
+                               UINT64_MAX};
+      std::copy(arr.begin(), arr.end(), keys);
+      sortFive(keys);
+      for (int k = 0; k < n; ++k) ASSERT_EQ(keys[k], k);
+    } while (std::next_permutation(arr.begin(), arr.end()));
+  }
+
+  std::uint32_t state = 1;
+  for (int k = 0; k < 100; ++k) ASSERT_NE(getRandomXorShift(state), 0);
+}
@@ -11,3 +11,17 @@ TEST(TP, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(TP, solve_by_sipp)
+{
+  auto P = MAPD_Instance("../tests/instances/tp_mapd.txt");
+  auto solver = std::make_unique<TP>(&P);
+  char arg0[] = "";
+  char arg1[] = "--sipp";
+  char* argv[] = {arg0, arg1};
+  solver->setParams(2, argv);
+  solver->solve();
+
+  ASSERT_TRUE(solver->succeed());
+  ASSERT_TRUE(solver->getSolution().validate(&P));
+}
@@ -2,7 +2,9 @@
 #include <random>
 #include <unordered_map>
 
+#include "mapped_file.hpp"
 #include "node.hpp"
+#include "stamped_array.hpp"
 
 using Path = std::vector<Node*>;    // < loc_i[0], loc_i[1], ... >
 
@@ -10,6 +12,15 @@ using Path = std::vector<Node*>;    // < loc_i[0], loc_i[1], ... >
 // Pure graph. Base class of Grid class.
 class Graph
 {
+public:
+  // maximal chain of nodes with degree <= 2
+  struct Corridor {
+    Nodes nodes;          // in order along the chain
+    Node* junctions[2];   // beyond nodes.front() / nodes.back(),
+                          // nullptr for a dead end
+    bool cyclic;          // ring without junctions
+  };
+
 private:
   /*
    * two approaches to find the shortest path
@@ -29,6 +40,8 @@ private:
   // helpers for cache
   std::vector<std::unordered_map<int, Path>*> PATH_TABLE;
   void initilizePathTable();
+  // closed list of the search
+  StampedArray<bool> CLOSE_TABLE;
   // get key name for cache
   static std::string getPathTableKey(const Node* const s, const Node* const g);
   // register already searched path to cache
@@ -39,10 +52,19 @@ protected:
   // V[y * width + x] = Node with position (x, y)
   // if (x, y) is occupied then V[y * width + x] = nullptr
   Nodes V;
+  std::vector<Node> node_block;  // nodes in one block, referred by V
+  Nodes adjacency;  // neighbors of all nodes in order (CSR), see Neighbors
 
   // something strange
   void halt(const std::string& msg);
 
+  // corridor decomposition, call after creating edges
+  std::vector<Corridor> corridors;
+  std::vector<int> corridor_id;   // node id -> corridor, -1 for junctions
+  std::vector<int> corridor_pos;  // node id -> index in the corridor
+  Nodes junctions;                // nodes with degree >= 3, sorted by id
+  void buildCorridors();
+
 public:
   Graph();
   virtual ~Graph();
@@ -70,6 +92,19 @@ public:
   // get all nodes without nullptr
   Nodes getV() const;
 
+  // corridor of v, -1 if v is a junction
+  int getCorridorId(const Node* const v) const { return corridor_id[v->id]; }
+  const Corridor& getCorridor(const int id) const { return corridors[id]; }
+  const Nodes& getJunctions() const { return junctions; }
+  // enter the corridor of 'to' from its neighbor 'from' and go through it,
+  // return {last node in the corridor, next node}, where the next node is
+  // a junction, or nullptr at a dead end or in a cyclic corridor, O(1)
+  std::pair<Node*, Node*> passCorridor(Node* const from,
+                                       Node* const to) const;
+  // whether v is on the corridor section between a and b (inclusive)
+  bool isOnCorridorSection(const Node* const v, const Node* const a,
+                           const Node* const b) const;
+
   // get width*height
   int getNodesSize() const { return V.size(); }
 };
@@ -81,6 +116,8 @@ private:
   int width;
   int height;
 
+  static bool isObstacle(const char s) { return s == 'T' || s == '@'; }
+
 public:
   Grid(){};
   Grid(const std::string& _map_file);
@@ -0,0 +1,113 @@
+/*
+ * Text file read by lines from a read-only memory mapping
+ *
+ * Lines are views into the mapping, split as std::getline does,
+ * and a trailing '\r' (CRLF) is dropped.
+ * Helpers match whole values of maps and instances, e.g., (\d+).
+ */
+
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+private:
+  bool opened;
+  void* data;
+  std::size_t data_size;
+  const char* cur;  // beginning of the next line
+  const char* end;
+
+public:
+  MappedFile(const std::string& file)
+      : opened(false), data(nullptr), data_size(0), cur(nullptr), end(nullptr)
+  {
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+      opened = true;
+      if (st.st_size > 0) {
+        data_size = st.st_size;
+        data = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+          data = nullptr;
+          opened = false;
+        }
+      }
+    }
+    ::close(fd);
+    if (data != nullptr) {
+      cur = static_cast<const char*>(data);
+      end = cur + data_size;
+    }
+  }
+  ~MappedFile()
+  {
+    if (data != nullptr) munmap(data, data_size);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // false if not found
+  bool isOpen() const { return opened; }
+
+  // next line without the line break, false at the end of the file
+  bool getLine(std::string_view& line)
+  {
+    if (cur >= end) return false;
+    auto eol = static_cast<const char*>(std::memchr(cur, '\n', end - cur));
+    if (eol == nullptr) eol = end;
+    std::size_t len = eol - cur;
+    if (len > 0 && cur[len - 1] == '\r') --len;
+    line = std::string_view(cur, len);
+    cur = (eol < end) ? eol + 1 : end;
+    return true;
+  }
+};
+
+// (\d+), whole s
+inline bool parseDigits(std::string_view s, int& value)
+{
+  if (s.empty()) return false;
+  int x = 0;
+  for (const char c : s) {
+    if (c < '0' || '9' < c) return false;
+    x = x * 10 + (c - '0');
+  }
+  value = x;
+  return true;
+}
+
+// "key=value", value is not empty, as key=(.+)
+inline bool parseKey(std::string_view line, std::string_view key,
+                     std::string_view& value)
+{
+  if (line.size() <= key.size() + 1 || line.substr(0, key.size()) != key ||
+      line[key.size()] != '=') {
+    return false;
+  }
+  value = line.substr(key.size() + 1);
+  return true;
+}
+
+// (\d+),(\d+),... with size of values, whole line
+template <int N>
+inline bool parseDigitsList(std::string_view line, int (&values)[N])
+{
+  for (int k = 0; k < N; ++k) {
+    const auto pos = (k < N - 1) ? line.find(',') : line.size();
+    if (pos == std::string_view::npos) return false;
+    if (!parseDigits(line.substr(0, pos), values[k])) return false;
+    if (k < N - 1) line.remove_prefix(pos + 1);
+  }
+  return true;
+}
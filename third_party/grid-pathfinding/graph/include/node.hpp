@@ -6,10 +6,26 @@
 struct Node;
 using Nodes = std::vector<Node*>;
 
+// neighbors of a node, a range of the adjacency array owned by the graph
+struct Neighbors {
+  Node* const* first = nullptr;
+  std::size_t len = 0;
+
+  Node* const* begin() const { return first; }
+  Node* const* end() const { return first + len; }
+  std::size_t size() const { return len; }
+  bool empty() const { return len == 0; }
+  Node* operator[](const std::size_t k) const { return first[k]; }
+  operator Nodes() const { return Nodes(begin(), end()); }
+};
+
 struct Node {
   const int id; //节点编号
   const Pos pos; //节点坐标(x,y)
-  Nodes neighbor; //邻居节点列表
+  Neighbors neighbor; //邻居节点列表
+  // neighbor in each direction, nullptr if blocked
+  // order: x+1, y+1, x-1, y-1 (counterclockwise)
+  Node* adjacent[4];
 
   Node(int _id, int x, int y);
   ~Node();
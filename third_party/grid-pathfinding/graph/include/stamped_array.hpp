@@ -0,0 +1,65 @@
+/*
+ * Array with O(1) clear
+ *
+ * Each entry is stamped with the epoch of its last write.
+ * Entries with an older stamp read as the default value,
+ * hence clear() only increments the epoch instead of refilling the array.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+template <typename T>
+class StampedArray
+{
+private:
+  std::vector<T> values;
+  std::vector<uint32_t> stamps;  // values[i] is valid iff stamps[i] == epoch
+  uint32_t epoch;
+  T default_value;
+
+public:
+  StampedArray(const int size = 0, const T& _default_value = T())
+      : values(size, _default_value),
+        stamps(size, 0),
+        epoch(1),
+        default_value(_default_value)
+  {
+  }
+  ~StampedArray() {}
+
+  T operator[](const int i) const
+  {
+    return (stamps[i] == epoch) ? values[i] : default_value;
+  }
+
+  void set(const int i, const T& value)
+  {
+    stamps[i] = epoch;
+    values[i] = value;
+  }
+
+  // whether i is written after the last clear
+  bool isSet(const int i) const { return stamps[i] == epoch; }
+
+  // all entries become the default value
+  void clear()
+  {
+    if (++epoch == 0) {  // wrap around, rarely happens
+      std::fill(stamps.begin(), stamps.end(), 0);
+      epoch = 1;
+    }
+  }
+
+  // drop all entries and change the size
+  void reset(const int size)
+  {
+    values.assign(size, default_value);
+    stamps.assign(size, 0);
+    epoch = 1;
+  }
+
+  int size() const { return values.size(); }
+};
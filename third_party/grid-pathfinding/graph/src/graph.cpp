@@ -1,17 +1,14 @@
 #include "../include/graph.hpp"
 #include<bits/stdc++.h>
 #include <chrono>
-#include <fstream>
 #include <iostream>
 #include <queue>
-#include <regex>
 using Time = std::chrono::steady_clock;
 
 Graph::Graph() {}
 
 Graph::~Graph()
 {
-  for (auto v : V) delete v;
   if (!PATH_TABLE.empty()) {
     for (auto table : PATH_TABLE) delete table;
   }
@@ -108,6 +105,7 @@ Path Graph::getPathWithCache(Node* const s, Node* const g, std::mt19937* MT)
 {
   // initialize cache
   if (PATH_TABLE.empty()) initilizePathTable();
+  if (CLOSE_TABLE.size() != (int)V.size()) CLOSE_TABLE.reset(V.size());
 
   struct AstarNode {
     Node* v;
@@ -123,8 +121,6 @@ Path Graph::getPathWithCache(Node* const s, Node* const g, std::mt19937* MT)
     return false;
   };
   std::function<AstarNode*(Node*, int, int, AstarNode*)> createNewNode;
-  std::function<bool(Node*)> isClosed;
-  std::function<void(Node*)> setClosed;
 
   // change data structure by graph size
   constexpr int huge_graph_size = 300000;
@@ -138,10 +134,10 @@ Path Graph::getPathWithCache(Node* const s, Node* const g, std::mt19937* MT)
   // garbage collection, for large field
   AstarNodes GC_L;
 
-  // closed list
-  bool CLOSE_S[MEMORY_SIZE];  // for small field
-  std::memset(CLOSE_S, false, sizeof(CLOSE_S));
-  std::unordered_map<int, bool> CLOSE_L;  // for large field
+  // closed list, cleared in O(1) for any field
+  CLOSE_TABLE.clear();
+  auto isClosed = [&](Node* v) { return CLOSE_TABLE[v->id]; };
+  auto setClosed = [&](Node* v) { CLOSE_TABLE.set(v->id, true); };
 
   if (is_small_graph) {
     createNewNode = [&](Node* v, int g, int f, AstarNode* p) {
@@ -154,17 +150,12 @@ Path Graph::getPathWithCache(Node* const s, Node* const g, std::mt19937* MT)
       q->p = p;
       return q;
     };
-    isClosed = [&](Node* v) { return CLOSE_S[v->id]; };
-    setClosed = [&](Node* v) { CLOSE_S[v->id] = true; };
-
   } else {
     createNewNode = [&](Node* v, int g, int f, AstarNode* p) {
       AstarNode* new_node = new AstarNode{v, g, f, p};
       GC_L.push_back(new_node);
       return new_node;
     };
-    isClosed = [&](Node* v) { return CLOSE_L.find(v->id) != CLOSE_L.end(); };
-    setClosed = [&](Node* v) { CLOSE_L[v->id] = true; };
   }
 
   // OPEN
@@ -314,73 +305,191 @@ Nodes Graph::getV() const
   return _V;
 }
 
-Grid::Grid(const std::string& _map_file) : Graph(), map_file(_map_file)
+void Graph::buildCorridors()
+{
+  corridors.clear();
+  junctions.clear();
+  corridor_id.assign(V.size(), -1);
+  corridor_pos.assign(V.size(), -1);
+  auto inChain = [](const Node* const v) { return v->getDegree() <= 2; };
+
+  for (auto v : V) {
+    if (v == nullptr) continue;
+    if (!inChain(v)) {
+      junctions.push_back(v);
+      continue;
+    }
+    if (corridor_id[v->id] != -1) continue;
+
+    // go to one end of the chain
+    Node* front = v;
+    Node* prev = nullptr;
+    bool cyclic = false;
+    while (true) {
+      Node* next = nullptr;
+      for (auto u : front->neighbor) {
+        if (u != prev && inChain(u)) next = u;
+      }
+      if (next == nullptr) break;
+      if (next == v) {  // ring
+        cyclic = true;
+        break;
+      }
+      prev = front;
+      front = next;
+    }
+
+    // collect nodes from the end
+    const int id = corridors.size();
+    Corridor c{{}, {nullptr, nullptr}, cyclic};
+    prev = nullptr;
+    for (Node* u = front; u != nullptr;) {
+      corridor_id[u->id] = id;
+      corridor_pos[u->id] = c.nodes.size();
+      c.nodes.push_back(u);
+      Node* next = nullptr;
+      for (auto w : u->neighbor) {
+        if (w != prev && inChain(w) && corridor_id[w->id] == -1) next = w;
+      }
+      prev = u;
+      u = next;
+    }
+
+    // junctions at both ends
+    if (!cyclic) {
+      for (auto u : c.nodes.front()->neighbor) {
+        if (!inChain(u)) {
+          c.junctions[0] = u;
+          break;
+        }
+      }
+      for (auto u : c.nodes.back()->neighbor) {
+        if (!inChain(u) && u != c.junctions[0]) c.junctions[1] = u;
+      }
+      if (c.nodes.size() > 1 && c.junctions[1] == nullptr) {
+        // both ends are attached to the same junction
+        for (auto u : c.nodes.back()->neighbor) {
+          if (!inChain(u)) c.junctions[1] = u;
+        }
+      }
+    }
+    corridors.push_back(c);
+  }
+}
+
+std::pair<Node*, Node*> Graph::passCorridor(Node* const from,
+                                            Node* const to) const
+{
+  const auto& c = corridors[corridor_id[to->id]];
+  if (c.cyclic) return {to, nullptr};
+  const int last = c.nodes.size() - 1;
+  if (last == 0) {
+    return {to, (c.junctions[0] == from) ? c.junctions[1] : c.junctions[0]};
+  }
+  // direction along the chain
+  const int pos = corridor_pos[to->id];
+  bool forward;
+  if (corridor_id[from->id] == corridor_id[to->id]) {
+    forward = corridor_pos[from->id] < pos;
+  } else {
+    forward = (pos == 0);
+  }
+  return forward ? std::make_pair(c.nodes[last], c.junctions[1])
+                 : std::make_pair(c.nodes[0], c.junctions[0]);
+}
+
+bool Graph::isOnCorridorSection(const Node* const v, const Node* const a,
+                                const Node* const b) const
+{
+  const int id = corridor_id[v->id];
+  if (id == -1 || id != corridor_id[a->id]) return false;
+  const int pos = corridor_pos[v->id];
+  const int pos_a = corridor_pos[a->id];
+  const int pos_b = corridor_pos[b->id];
+  return std::min(pos_a, pos_b) <= pos && pos <= std::max(pos_a, pos_b);
+}
+
+Grid::Grid(const std::string& _map_file)
+    : Graph(), map_file(_map_file), width(0), height(0)
 {
   // read map file
 #ifdef _MAPDIR_
-  std::ifstream file(_MAPDIR_ + map_file);
+  MappedFile file(_MAPDIR_ + map_file);
 #else
-  std::ifstream file(map_file);
+  MappedFile file(map_file);
 #endif
 
-  if (!file) halt("file " + map_file + " is not found.");
-
-  std::string line;
-  std::smatch results;
-  std::regex r_height = std::regex(R"(height\s(\d+))");
-  std::regex r_width = std::regex(R"(width\s(\d+))");
-  std::regex r_map = std::regex(R"(map)");
-
-  // fundamental graph params
-  while (getline(file, line)) {
-    // for CRLF coding
-    if (*(line.end() - 1) == 0x0d) line.pop_back();
+  if (!file.isOpen()) halt("file " + map_file + " is not found.");
 
-    if (std::regex_match(line, results, r_height)) {
-      height = std::stoi(results[1].str());
+  // fundamental graph params, "height\s(\d+)", "width\s(\d+)" until "map"
+  std::string_view line;
+  auto readParam = [&](const std::string_view key, int& value) {
+    if (line.size() > key.size() && line.substr(0, key.size()) == key &&
+        std::isspace((unsigned char)line[key.size()])) {
+      parseDigits(line.substr(key.size() + 1), value);
     }
-    if (std::regex_match(line, results, r_width)) {
-      width = std::stoi(results[1].str());
-    }
-    if (std::regex_match(line, results, r_map)) break;
+  };
+  while (file.getLine(line)) {
+    readParam("height", height);
+    readParam("width", width);
+    if (line == "map") break;
   }
   if (!(width > 0 && height > 0)) halt("failed to load width/height.");
 
-  // create nodes
-  int y = 0;
-  V = Nodes(width * height, nullptr);
-  while (getline(file, line)) {
-    // for CRLF coding
-    if (*(line.end() - 1) == 0x0d) line.pop_back();
-
+  // rows, counting nodes to allocate them at once
+  std::vector<std::string_view> rows;
+  int nodes_size = 0;
+  while (file.getLine(line)) {
     if ((int)line.size() != width) halt("map format is invalid");
-    for (int x = 0; x < width; ++x) {
-      char s = line[x];
-      if (s == 'T' or s == '@') continue;  // object
-      int id = width * y + x; //使用二维坐标到一维的映射，从左到右，从上到下依次标号
-      Node* v = new Node(id, x, y);
-      V[id] = v;
-    }
-    ++y;
+    for (const char s : line) nodes_size += !isObstacle(s);
+    rows.push_back(line);
   }
-  if (y != height) halt("map format is invalid");
-  file.close();
+  if ((int)rows.size() != height) halt("map format is invalid");
 
-  // create edges
+  // create nodes, ids from left to right, top to bottom
+  V = Nodes(width * height, nullptr);
+  node_block.reserve(nodes_size);
   for (int y = 0; y < height; ++y) {
     for (int x = 0; x < width; ++x) {
-      if (!existNode(x, y)) continue;
-      Node* v = getNode(x, y); //对每个节点，检查其4个方向上是否存在可达节点，并加入neighbor列表
-      // left
-      if (existNode(x - 1, y)) v->neighbor.push_back(getNode(x - 1, y));
-      // right
-      if (existNode(x + 1, y)) v->neighbor.push_back(getNode(x + 1, y));
-      // up
-      if (existNode(x, y - 1)) v->neighbor.push_back(getNode(x, y - 1));
-      // down
-      if (existNode(x, y + 1)) v->neighbor.push_back(getNode(x, y + 1));
+      if (isObstacle(rows[y][x])) continue;
+      const int id = width * y + x;
+      node_block.emplace_back(id, x, y);
+      V[id] = &node_block.back();
     }
   }
+
+  // create edges in one pass, neighbors are ordered by left, right, up, down
+  auto at = [&](const int x, const int y) -> Node* {
+    return (0 <= x && x < width && 0 <= y && y < height) ? V[width * y + x]
+                                                         : nullptr;
+  };
+  std::vector<int> offsets(nodes_size + 1, 0);
+  adjacency.reserve(4 * nodes_size);
+  for (int k = 0; k < nodes_size; ++k) {
+    Node* v = &node_block[k];
+    const int x = v->pos.x;
+    const int y = v->pos.y;
+    Node* const left = at(x - 1, y);
+    Node* const right = at(x + 1, y);
+    Node* const up = at(x, y - 1);
+    Node* const down = at(x, y + 1);
+    offsets[k] = adjacency.size();
+    for (Node* u : {left, right, up, down}) {
+      if (u != nullptr) adjacency.push_back(u);
+    }
+    // by direction
+    v->adjacent[0] = right;
+    v->adjacent[1] = down;
+    v->adjacent[2] = left;
+    v->adjacent[3] = up;
+  }
+  offsets[nodes_size] = adjacency.size();
+  for (int k = 0; k < nodes_size; ++k) {
+    node_block[k].neighbor.first = adjacency.data() + offsets[k];
+    node_block[k].neighbor.len = offsets[k + 1] - offsets[k];
+  }
+
+  buildCorridors();
 }
 
 bool Grid::existNode(int id) const
@@ -4,7 +4,9 @@
 #include <iostream>
 
 Node::Node(int _id, int x, int y)
-    : id(_id), pos(Pos(x, y)), neighbor(std::vector<Node*>(0))
+    : id(_id),
+      pos(Pos(x, y)),
+      adjacent{nullptr, nullptr, nullptr, nullptr}
 {
 }
 
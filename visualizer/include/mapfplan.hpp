@@ -1,24 +1,82 @@
 #pragma once
+#include <memory>
+
 #include "../../third_party/grid-pathfinding/graph/include/graph.hpp"
+#include "../../pibt2/include/result_log.hpp"
 
 using Config = std::vector<Node*>;
 using Configs = std::vector<Config>;
 
+/*
+ * result file shown by the visualizer
+ *
+ * - the file is memory-mapped and indexed by timesteps when opened,
+ *   text results are scanned for rows, binary results
+ *   (--log-format=binary) have the index in the file
+ * - configurations are decoded on demand for a window of timesteps around
+ *   the requested one, hence seeking is instant and memory stays flat
+ *   regardless of the makespan
+ */
 struct MAPFPlan {
-  int num_agents;         // number of agents
-  Grid* G;                // grid
-  std::string solver;     // solver name
-  bool solved;            // success or not
-  int soc;                // sum of cost
-  int makespan;           // makespan
-  int comp_time;          // computation time
-  Config config_s;        // start configuration
-  Config config_g;        // goal configuration
-  Configs transitions;    // plan
+  int num_agents = 0;       // number of agents
+  Grid* G = nullptr;        // grid
+  std::string solver;       // solver name
+  bool solved = false;      // success or not
+  int soc = 0;              // sum of cost
+  int makespan = 0;         // makespan
+  int comp_time = 0;        // computation time
+  Config config_s;          // start configuration
+  Config config_g;          // goal configuration
   // for MAPD
-  float service_time;     // service_time
-  Configs targets;        // targets
-  std::vector<std::vector<bool>> assigned;  // as
+  float service_time = 0;   // service_time
+
+private:
+  static constexpr std::size_t WINDOW_NODES = 1 << 22;  // decoded at once
+  static constexpr int MIN_WINDOW = 16;
+
+  // mapped file
+  void* data = nullptr;
+  std::size_t data_size = 0;
+  std::unique_ptr<ResultLogReader> binary;  // binary result
+  std::vector<std::size_t> row_offsets;     // text result, the end follows
+  int timesteps = 0;
+  bool mapd = false;
+
+  // decoded rows of [window_begin, window_begin + transitions.size())
+  int window_begin = 0;
+  Configs transitions;                      // plan
+  Configs targets;                          // MAPD, targets
+  std::vector<std::vector<bool>> assigned;  // MAPD, with tasks or not
+
+  void readInfo(const char* s, const char* end);
+  void readConfig(const char* s, const char* end, Config& config,
+                  Config& _targets, std::vector<bool>& _assigned) const;
+  Node* getNode(const int x, const int y) const;
+  void load(const int t);
+  void halt(const std::string& msg) const;
+
+public:
+  MAPFPlan(const std::string& result_file);
+  ~MAPFPlan();
+
+  int getTimesteps() const { return timesteps; }
+  bool isMAPD() const { return mapd; }
+  // timesteps before this are decoded together with the last requested one
+  int getWindowEnd() const { return window_begin + transitions.size(); }
 
-  ~MAPFPlan() { delete G; }
+  Node* getLocation(const int t, const int i)
+  {
+    load(t);
+    return transitions[t - window_begin][i];
+  }
+  Node* getTarget(const int t, const int i)
+  {
+    load(t);
+    return targets[t - window_begin][i];
+  }
+  bool isAssigned(const int t, const int i)
+  {
+    load(t);
+    return assigned[t - window_begin][i];
+  }
 };
@@ -0,0 +1,217 @@
+#include "../include/mapfplan.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+
+static const char* findEndOfLine(const char* s, const char* end)
+{
+  auto eol = static_cast<const char*>(std::memchr(s, '\n', end - s));
+  return (eol == nullptr) ? end : eol;
+}
+
+MAPFPlan::MAPFPlan(const std::string& result_file)
+{
+  // binary result, rows are indexed in the file
+  if (ResultLogReader::isBinary(result_file)) {
+    binary = std::make_unique<ResultLogReader>(result_file);
+    const auto& preamble = binary->getPreamble();
+    readInfo(preamble.data(), preamble.data() + preamble.size());
+    timesteps = binary->getTimesteps();
+    mapd = (binary->getKind() == ResultLog::Kind::MAPD);
+    return;
+  }
+
+  const int fd = ::open(result_file.c_str(), O_RDONLY);
+  if (fd < 0) halt("file " + result_file + " is not found.");
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    data_size = st.st_size;
+    data = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) data = nullptr;
+  }
+  ::close(fd);
+  if (data == nullptr) halt("failed to read " + result_file);
+  const char* s = static_cast<const char*>(data);
+  const char* end = s + data_size;
+
+  // rows follow the line "solution="
+  const char* rows = end;
+  for (const char* p = s; p < end;) {
+    const char* eol = findEndOfLine(p, end);
+    if (eol - p == 9 && std::memcmp(p, "solution=", 9) == 0) {
+      rows = std::min(eol + 1, end);
+      break;
+    }
+    p = eol + 1;
+  }
+  readInfo(s, rows);
+
+  // index rows, "t:..."
+  for (const char* p = rows; p < end;) {
+    const char* eol = findEndOfLine(p, end);
+    if (p < eol && std::isdigit(*p)) row_offsets.push_back(p - s);
+    p = eol + 1;
+  }
+  timesteps = row_offsets.size();
+  if (timesteps > 0) {
+    const char* p = s + row_offsets[0];
+    const char* eol = findEndOfLine(p, end);
+    mapd = std::find(p, eol, '>') != eol;  // "(x,y)->(x,y):task,"
+  }
+}
+
+MAPFPlan::~MAPFPlan()
+{
+  if (data != nullptr) munmap(data, data_size);
+  delete G;
+}
+
+// key=value lines
+void MAPFPlan::readInfo(const char* s, const char* end)
+{
+  for (const char* p = s; p < end;) {
+    const char* eol = findEndOfLine(p, end);
+    auto eq = std::find(p, eol, '=');
+    if (eq != eol) {
+      const std::string key(p, eq);
+      const std::string value(eq + 1, eol);
+      Config targets;
+      std::vector<bool> assigned;
+      if (key == "map_file") {
+        delete G;
+        G = new Grid(value);
+      } else if (key == "agents") {
+        num_agents = std::stoi(value);
+      } else if (key == "solver") {
+        solver = value;
+      } else if (key == "solved") {
+        solved = (bool)std::stoi(value);
+      } else if (key == "soc") {
+        soc = std::stoi(value);
+      } else if (key == "makespan") {
+        makespan = std::stoi(value);
+      } else if (key == "comp_time") {
+        comp_time = std::stoi(value);
+      } else if (key == "service_time") {
+        service_time = std::stof(value);
+      } else if (key == "starts") {
+        readConfig(eq + 1, eol, config_s, targets, assigned);
+      } else if (key == "goals") {
+        readConfig(eq + 1, eol, config_g, targets, assigned);
+      }
+    }
+    p = eol + 1;
+  }
+}
+
+// "(x,y),...", "(x,y,ORIENTATION),..." or "(x,y)->(x,y):task,..."
+void MAPFPlan::readConfig(const char* s, const char* end, Config& config,
+                          Config& _targets,
+                          std::vector<bool>& _assigned) const
+{
+  const char* p = s;
+  auto readInt = [&]() {
+    const bool negative = (p < end && *p == '-');
+    if (negative) ++p;
+    int x = 0;
+    while (p < end && std::isdigit(*p)) x = x * 10 + (*p++ - '0');
+    return negative ? -x : x;
+  };
+  auto skip = [&](const char c) {
+    if (p >= end || *p != c) halt("invalid result file");
+    ++p;
+  };
+
+  while (p < end && *p == '(') {
+    ++p;
+    const int x = readInt();
+    skip(',');
+    const int y = readInt();
+    while (p < end && *p != ')') ++p;  // orientation
+    skip(')');
+    config.push_back(getNode(x, y));
+    if (p < end && *p == '-') {
+      skip('-');
+      skip('>');
+      skip('(');
+      const int target_x = readInt();
+      skip(',');
+      const int target_y = readInt();
+      skip(')');
+      skip(':');
+      _targets.push_back(getNode(target_x, target_y));
+      _assigned.push_back(readInt() != -1);
+    }
+    skip(',');
+  }
+}
+
+Node* MAPFPlan::getNode(const int x, const int y) const
+{
+  if (G == nullptr) halt("no graph");
+  if (!G->existNode(x, y)) halt("node does not exist");
+  return G->getNode(x, y);
+}
+
+// decode a window of timesteps including t
+void MAPFPlan::load(const int t)
+{
+  if (window_begin <= t && t < getWindowEnd()) return;
+  if (t < 0 || t >= timesteps) {
+    halt("timestep " + std::to_string(t) + " is out of range");
+  }
+  const int window = std::max<int>(
+      MIN_WINDOW, WINDOW_NODES / std::max(1, num_agents));
+  window_begin = std::max(0, std::min(t - window / 4, timesteps - window));
+  const int window_size = std::min(timesteps - window_begin, window);
+  transitions.assign(window_size, Config());
+  targets.assign(mapd ? window_size : 0, Config());
+  assigned.assign(mapd ? window_size : 0, std::vector<bool>());
+
+  if (binary != nullptr) {
+    const int width = G->getWidth();
+    binary->read(window_begin, window_begin + window_size,
+                 [&](const int s, const ResultLog::Row& row) {
+      const int k = s - window_begin;
+      for (int i = 0; i < (int)row.node_ids.size(); ++i) {
+        const int v = row.node_ids[i];
+        transitions[k].push_back(getNode(v % width, v / width));
+        if (!mapd) continue;
+        const int u = row.target_ids[i];
+        targets[k].push_back(getNode(u % width, u / width));
+        assigned[k].push_back(row.task_ids[i] != -1);  // Task::NIL
+      }
+    });
+  } else {
+    const char* s = static_cast<const char*>(data);
+    const char* end = s + data_size;
+    Config dummy_targets;
+    std::vector<bool> dummy_assigned;
+    for (int k = 0; k < window_size; ++k) {
+      const char* p = s + row_offsets[window_begin + k];
+      const char* eol = findEndOfLine(p, end);
+      p = std::find(p, eol, ':');
+      if (p == eol) halt("invalid result file");
+      readConfig(p + 1, eol, transitions[k],
+                 mapd ? targets[k] : dummy_targets,
+                 mapd ? assigned[k] : dummy_assigned);
+    }
+  }
+
+  for (auto& c : transitions) {
+    if ((int)c.size() != num_agents) halt("invalid result file");
+  }
+}
+
+void MAPFPlan::halt(const std::string& msg) const
+{
+  std::cout << "error@main, " << msg << std::endl;
+  std::exit(1);
+}
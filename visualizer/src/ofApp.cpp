@@ -108,8 +108,8 @@ void ofApp::draw()
       int t1 = (int)timestep_slider;
       if (!P->config_g.empty()) {
         g = P->config_g[i];  // mapf
-      } else if (!P->targets.empty() && t1 <= P->targets.size() - 1) {
-        g = P->targets[t1][i];  // mapd
+      } else if (P->isMAPD() && t1 < P->getTimesteps()) {
+        g = P->getTarget(t1, i);  // mapd
       } else {
         std::cout << "invalid result file" << std::endl;
         std::exit(1);
@@ -130,13 +130,13 @@ void ofApp::draw()
     int t2 = t1 + 1;
 
     // agent position
-    Node* v = P->transitions[t1][i];
+    Node* v = P->getLocation(t1, i);
     Pos pos1 = v->pos;
     float x = pos1.x;
     float y = pos1.y;
 
     if (t2 <= P->makespan) {
-      Pos pos2 = P->transitions[t2][i]->pos;
+      Pos pos2 = P->getLocation(t2, i)->pos;
       x += (pos2.x - x) * (timestep_slider - t1);
       y += (pos2.y - y) * (timestep_slider - t1);
     }
@@ -157,8 +157,8 @@ void ofApp::draw()
       Pos pos3 = v->pos;
       if (!P->config_g.empty()) {
         pos3 = P->config_g[i]->pos * scale;
-      } else if (!P->targets.empty() && t1 <= P->targets.size() - 1) {
-        pos3 = P->targets[t1][i]->pos * scale;
+      } else if (P->isMAPD() && t1 < P->getTimesteps()) {
+        pos3 = P->getTarget(t1, i)->pos * scale;
       } else {
         std::cout << "invalid result file" << std::endl;
         std::exit(1);
@@ -166,11 +166,12 @@ void ofApp::draw()
       ofDrawLine(pos3.x + BufferSize::window_x_buffer + scale/2,
                  pos3.y + BufferSize::window_y_top_buffer + scale/2, x, y);
     } else if (line_mode == LINE_MODE::PATH) {
-      // next loc
+      // next loc, within the decoded timesteps
       ofSetLineWidth(2);
       Pos pos2(x-BufferSize::window_x_buffer-scale/2, y-BufferSize::window_y_top_buffer-scale/2);
-      for (int t = t1; t < P->makespan; ++t) {
-        Pos pos3 = P->transitions[t+1][i]->pos * scale;
+      int t_end = std::min(P->makespan, P->getWindowEnd() - 1);
+      for (int t = t1; t < t_end; ++t) {
+        Pos pos3 = P->getLocation(t+1, i)->pos * scale;
         if (pos3 == pos2) continue;
         ofDrawLine(pos2.x + BufferSize::window_x_buffer + scale/2,
                    pos2.y + BufferSize::window_y_top_buffer + scale/2,
@@ -186,7 +187,7 @@ void ofApp::draw()
     if (!P->config_g.empty() && v == P->config_g[i] && !flg_logo_gen) {
       ofSetColor(255,255,255);
       ofDrawCircle(x, y, agent_rad-2);
-    } else if (!P->assigned.empty() && !P->assigned[t1].empty() && P->assigned[t1][i]) {
+    } else if (P->isMAPD() && P->isAssigned(t1, i)) {
       ofSetColor(255,255,255);
       ofDrawCircle(x, y, agent_rad-2);
     }